@@ -0,0 +1,332 @@
+/*
+ * Cycle-accurate kernel benchmarks for RPMegaRacer (llvm-mos sim platform)
+ *
+ * Loads each track through the real load_track(), drives the hot kernels
+ * over positions sampled along the track's racing line and reports the
+ * average and worst 6502 cycle count per call. Exits non-zero if any
+ * kernel's worst case is over its budget in budgets.h. Also prints how
+ * often each track's physics missed the terrain row cache.
+ *
+ * Built twice: the normal 4-car field and an 8-car field (NUM_AI_CARS=7)
+ * so the per-car cost of the AI, collision and draw loops can be compared.
+ * Then races the field through real-length frames and fails if update_ai
+ * never finds time for a brain beyond the overdue ones.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <rp6502.h>
+#include "constants.h"
+#include "track.h"
+#include "player.h"
+#include "ai.h"
+#include "collision.h"
+#include "racelogic.h"
+#include "input.h"
+#include "xram.h"
+#include "particles.h"
+#include "colliders.h"
+#include "pacing.h"
+#include "sched.h"
+#include "budgets.h"
+
+#define SAMPLES_PER_TRACK 48
+#define BRAIN_FRAMES      120
+
+extern int16_t next_scroll_x, next_scroll_y; // Camera (ria_stub.c)
+extern void bench_frame_start(uint16_t units);  // Frame timer (ria_stub.c)
+
+typedef struct {
+    const char *name;
+    uint32_t budget; // Worst-case cycles per call
+    bool per_frame;  // Runs once in every racing frame (counts toward K_FRAME)
+    uint32_t worst;
+    uint32_t total;
+    uint16_t calls;
+} Kernel;
+
+enum {
+    K_GET_TERRAIN_AT,
+    K_TERRAIN_DYN_FAR,
+    K_TERRAIN_DYN_NEAR,
+    K_TERRAIN_ROW_MISS,
+    K_TERRAIN_PREFETCH,
+    K_TRACK_STREAM_STEP,
+    K_IS_COLLIDING_FAST,
+    K_ATAN2_8,
+    K_UPDATE_AI,
+    K_UPDATE_PLAYER,
+    K_RESOLVE_COLLISIONS,
+    K_DRAW_AI_CARS,
+    K_UPDATE_PARTICLES,
+    K_DRAW_PARTICLES,
+    K_FRAME,
+    K_COUNT
+};
+
+static Kernel kernels[K_COUNT] = {
+    [K_GET_TERRAIN_AT]     = {.name = "get_terrain_at",         .budget = BUDGET_GET_TERRAIN_AT},
+    [K_TERRAIN_DYN_FAR]    = {.name = "  +colliders, far tile", .budget = BUDGET_GET_TERRAIN_AT},
+    [K_TERRAIN_DYN_NEAR]   = {.name = "  +colliders, near tile", .budget = BUDGET_TERRAIN_DYN_NEAR},
+    [K_TERRAIN_ROW_MISS]   = {.name = "  +row cache miss",      .budget = BUDGET_TERRAIN_ROW_MISS},
+    [K_TERRAIN_PREFETCH]   = {.name = "terrain_cache_prefetch", .budget = BUDGET_TERRAIN_PREFETCH, .per_frame = true},
+    [K_TRACK_STREAM_STEP]  = {.name = "track_stream_step",      .budget = BUDGET_TRACK_STREAM_STEP},
+    [K_IS_COLLIDING_FAST]  = {.name = "is_colliding_fast",      .budget = BUDGET_IS_COLLIDING_FAST},
+    [K_ATAN2_8]            = {.name = "atan2_8",                .budget = BUDGET_ATAN2_8},
+    [K_UPDATE_AI]          = {.name = "update_ai",              .budget = BUDGET_UPDATE_AI, .per_frame = true},
+    [K_UPDATE_PLAYER]      = {.name = "update_player",          .budget = BUDGET_UPDATE_PLAYER, .per_frame = true},
+    [K_RESOLVE_COLLISIONS] = {.name = "resolve_all_collisions", .budget = BUDGET_RESOLVE_COLLISIONS, .per_frame = true},
+    [K_DRAW_AI_CARS]       = {.name = "draw_ai_cars",           .budget = BUDGET_DRAW_AI_CARS, .per_frame = true},
+    [K_UPDATE_PARTICLES]   = {.name = "update_particles",       .budget = BUDGET_UPDATE_PARTICLES, .per_frame = true},
+    [K_DRAW_PARTICLES]     = {.name = "draw_particles",         .budget = BUDGET_DRAW_PARTICLES, .per_frame = true},
+    [K_FRAME]              = {.name = "racing frame (benched)", .budget = BUDGET_FRAME},
+};
+
+// What budgets.h should say for a measured worst case: the margin on top,
+// rounded up to a whole BUDGET_ROUND
+static uint32_t calibrated_budget(uint32_t worst) {
+    uint32_t b = worst + worst * BUDGET_MARGIN_PERCENT / 100;
+    return (b + BUDGET_ROUND - 1) / BUDGET_ROUND * BUDGET_ROUND;
+}
+
+// On the sim platform clock() counts elapsed 6502 cycles
+static uint32_t timer_overhead = 0;
+static uint32_t frame_cycles; // Per-frame kernels so far in this sample
+
+static uint32_t read_cycles(void) {
+    return (uint32_t)clock();
+}
+
+static void tally(uint8_t k, uint32_t elapsed) {
+    Kernel *kn = &kernels[k];
+    if (elapsed > kn->worst) kn->worst = elapsed;
+    kn->total += elapsed;
+    kn->calls++;
+}
+
+static void record(uint8_t k, uint32_t elapsed) {
+    elapsed = (elapsed > timer_overhead) ? elapsed - timer_overhead : 0;
+    if (kernels[k].per_frame) frame_cycles += elapsed;
+    tally(k, elapsed);
+}
+
+#define MEASURE(k, call)                        \
+    do {                                        \
+        uint32_t t0 = read_cycles();            \
+        call;                                   \
+        record((k), read_cycles() - t0);        \
+    } while (0)
+
+// Results land here so LTO can't drop the measured calls
+static volatile uint8_t sink;
+
+// Positions along the waypoint loop (pixels, car centre)
+static int16_t sample_x[SAMPLES_PER_TRACK];
+static int16_t sample_y[SAMPLES_PER_TRACK];
+
+static void build_samples(void) {
+    uint16_t count = g_num_active_waypoints;
+    for (uint8_t s = 0; s < SAMPLES_PER_TRACK; s++) {
+        // 4 bits of sub-segment fraction
+        uint16_t pos = ((uint16_t)s * count * 16) / SAMPLES_PER_TRACK;
+        uint8_t seg = pos >> 4;
+        uint8_t frac = pos & 15;
+        uint8_t next = (seg + 1 < count) ? seg + 1 : 0;
+
+        int16_t dx = waypoints[next].x - waypoints[seg].x;
+        int16_t dy = waypoints[next].y - waypoints[seg].y;
+        sample_x[s] = waypoints[seg].x + ((dx * frac) >> 4);
+        sample_y[s] = waypoints[seg].y + ((dy * frac) >> 4);
+    }
+}
+
+static uint8_t heading_at(uint8_t s) {
+    uint8_t n = (s + 1) % SAMPLES_PER_TRACK;
+    uint8_t standard_angle = atan2_8(sample_y[n] - sample_y[s], sample_x[n] - sample_x[s]);
+    return (192 - standard_angle) & 0xFF; // Game's CCW 0=Up system
+}
+
+static void place_car(uint8_t slot, int16_t cx, int16_t cy, uint8_t angle) {
+    // Car x/y is the sprite's top-left in 10.6; samples are centres
+    CAR_SET16(car_x, slot, (cx - 8) << 6);
+    CAR_SET16(car_y, slot, (cy - 8) << 6);
+    car_angle[slot] = angle;
+    CAR_SET16(car_vx, slot, (int16_t)SIN_LUT[angle] * -2);
+    CAR_SET16(car_vy, slot, (int16_t)SIN_LUT[(angle + 64) & 0xFF] * -2);
+}
+
+static void bench_track(int track_id) {
+    current_track_id = track_id;
+    reset_race(); // Real load_track() + grid
+    build_samples();
+    uint16_t physics_misses = 0;
+
+    current_state = STATE_RACING;
+    countdown_active = true;
+    state_timer = 0;
+
+    for (uint8_t s = 0; s < SAMPLES_PER_TRACK; s++) {
+        int16_t x = sample_x[s];
+        int16_t y = sample_y[s];
+        uint8_t n = (s + 1) % SAMPLES_PER_TRACK;
+
+        // A probe on an uncached row, then bring in the rows every probe
+        // below touches so they measure the cached path
+        terrain_cache_flush();
+        MEASURE(K_TERRAIN_ROW_MISS, sink = get_terrain_at(x, y));
+        for (int16_t wy = y - 32; wy <= y + 16; wy += 8) sink = get_terrain_at(x, wy);
+
+        // Terrain probes on the line and 20px off it (often a wall)
+        MEASURE(K_GET_TERRAIN_AT, sink = get_terrain_at(x, y));
+        MEASURE(K_GET_TERRAIN_AT, sink = get_terrain_at(x + 20, y - 20));
+
+        // Same probes with a full table of moving boxes next to the line:
+        // tiles they don't touch must cost the same as with none at all
+        for (uint8_t c = 0; c < MAX_COLLIDERS; c++) {
+            collider_add(x + 24 + 6 * c, y - 12, 5, 24);
+        }
+        MEASURE(K_TERRAIN_DYN_FAR, sink = get_terrain_at(x, y));
+        MEASURE(K_TERRAIN_DYN_FAR, sink = get_terrain_at(x - 20, y - 20));
+        MEASURE(K_TERRAIN_DYN_NEAR, sink = get_terrain_at(x + 24 + 6 * (MAX_COLLIDERS - 1), y)); // Last box
+        MEASURE(K_TERRAIN_DYN_NEAR, sink = get_terrain_at(x + 29, y));                           // Tile, no box
+        colliders_clear();
+
+        MEASURE(K_IS_COLLIDING_FAST, sink = is_colliding_fast(x - 8, y - 8));
+        MEASURE(K_IS_COLLIDING_FAST, sink = is_colliding_fast(x + 12, y - 28));
+        MEASURE(K_ATAN2_8, sink = atan2_8(sample_y[n] - y, sample_x[n] - x));
+        MEASURE(K_ATAN2_8, sink = atan2_8(waypoints[0].y - y, waypoints[0].x - x));
+
+        // Player on the sample, AI spread over the next samples
+        uint8_t heading = heading_at(s);
+        place_car(PLAYER_SLOT, x, y, heading);
+        for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+            uint8_t a = (s + 2 * i) % SAMPLES_PER_TRACK;
+            place_car(i, sample_x[a], sample_y[a], heading_at(a));
+        }
+
+        // Cars jumped here from the last sample: the cold prefetch isn't a
+        // real frame, the one after the physics step is. A streamed track
+        // brings in the chunks around the new camera first, one per step
+        // as the map_stream task would.
+        update_camera();
+        for (bool more = true; more; ) {
+            MEASURE(K_TRACK_STREAM_STEP, more = track_stream_step(-next_scroll_x, -next_scroll_y));
+        }
+        terrain_cache_prefetch(-next_scroll_x, -next_scroll_y);
+        uint16_t misses_before = terrain_cache_misses;
+        frame_cycles = 0;
+
+        // Player: throttle held, steering alternating
+        action_held[0] = ACTION_BIT(ACTION_FIRE) |
+                         ((s & 1) ? ACTION_BIT(ACTION_ROTATE_LEFT) : ACTION_BIT(ACTION_ROTATE_RIGHT));
+        action_pressed[0] = 0;
+        MEASURE(K_UPDATE_PLAYER, update_player());
+        MEASURE(K_UPDATE_AI, update_ai());
+        physics_misses += terrain_cache_misses - misses_before;
+        MEASURE(K_TERRAIN_PREFETCH, terrain_cache_prefetch(-next_scroll_x, -next_scroll_y));
+
+        update_camera();
+        MEASURE(K_DRAW_AI_CARS, draw_ai_cars(next_scroll_x, next_scroll_y));
+
+        // Collisions: pack the whole field around the sample so contacts happen
+        for (uint8_t i = 0; i < NUM_CARS; i++) {
+            place_car(i, x + 6 * (i & 1) + 3 * (i >> 2), y + 6 * ((i >> 1) & 1), heading);
+        }
+        MEASURE(K_RESOLVE_COLLISIONS, resolve_all_collisions());
+
+        // Particles: a pile-up's worth of spawns, more than the frame budget takes
+        particle_spawn(PART_SPARK, x, y, 8);
+        particle_spawn(PART_SMOKE, x, y, 4);
+        particle_spawn(PART_DUST, x, y, 4);
+        MEASURE(K_UPDATE_PARTICLES, update_particles());
+        MEASURE(K_DRAW_PARTICLES, draw_particles(next_scroll_x, next_scroll_y));
+
+        // Everything above that a racing frame runs has to fit in one frame
+        tally(K_FRAME, frame_cycles);
+    }
+
+    // Player and AI updates should find every row already prefetched, and
+    // on a streamed track every chunk already in the window
+    printf("Track %d: %u terrain cache misses in physics, %u row fills, %u chunks forced%s\n",
+           track_id, physics_misses, terrain_cache_fills, track_chunks_forced,
+           track_streaming ? " (streamed)" : "");
+}
+
+// The kernel samples give update_ai an endless frame, so every brain runs.
+// Here the field races from the grid through frames of the real length,
+// with the pacing marks the main loop makes, and update_ai plans its
+// brains from the costs it measures. Returns the brains it ran on top of
+// the overdue ones.
+static uint16_t bench_brains(void) {
+    current_track_id = 1;
+    reset_race();
+    current_state = STATE_RACING;
+    countdown_active = true;
+    state_timer = 0;
+
+    for (uint8_t f = 0; f < BRAIN_FRAMES; f++) {
+        bench_frame_start(SCHED_FRAME_UNITS);
+        RIA.vsync++;
+        pacing_frame_start(RIA.vsync, current_state);
+
+        update_camera();
+        terrain_cache_prefetch(-next_scroll_x, -next_scroll_y);
+        pacing_mark(PACE_INPUT);
+        action_held[0] = ACTION_BIT(ACTION_FIRE);
+        action_pressed[0] = 0;
+        update_player();
+        pacing_mark(PACE_PLAYER);
+        update_ai();
+        pacing_mark(PACE_AI);
+        resolve_all_collisions();
+        update_particles();
+        pacing_mark(PACE_COLLIDE);
+        update_camera();
+        draw_ai_cars(next_scroll_x, next_scroll_y);
+        draw_particles(next_scroll_x, next_scroll_y);
+        pacing_mark(PACE_LOGIC);
+    }
+    bench_frame_start(0xFFFF);
+
+    printf("Brains over %u real frames: %u run, %u overdue\n",
+           BRAIN_FRAMES, ai_brains_run, ai_brains_forced);
+    return ai_brains_run - ai_brains_forced;
+}
+
+int main(void) {
+    xram_init(); // load_track() places tiles and maps through the allocator
+    init_particles();
+
+    // Calibrate the cost of the measurement itself
+    uint32_t t0 = read_cycles();
+    timer_overhead = read_cycles() - t0;
+
+    for (int track_id = 1; track_id <= NUM_TRACKS; track_id++) {
+        bench_track(track_id);
+    }
+
+    bool over_budget = false;
+    if (bench_brains() == 0) {
+        printf("NO BRAINS SCHEDULED beyond the overdue ones\n");
+        over_budget = true;
+    }
+
+    printf("\n%d-car field\n", NUM_CARS);
+#if !BUDGETS_CALIBRATED
+    printf("Budgets are estimates until calibrated (budgets.h); the frame row is real\n");
+#endif
+    printf("%-24s %8s %8s %8s %10s\n", "kernel", "avg", "worst", "budget", "calibrated");
+    for (uint8_t k = 0; k < K_COUNT; k++) {
+        Kernel *kn = &kernels[k];
+        uint32_t avg = kn->calls ? kn->total / kn->calls : 0;
+        bool over = kn->worst > kn->budget;
+        if (over) over_budget = true;
+        printf("%-24s %8lu %8lu %8lu %10lu%s\n", kn->name,
+               (unsigned long)avg, (unsigned long)kn->worst, (unsigned long)kn->budget,
+               (unsigned long)calibrated_budget(kn->worst), over ? "  OVER BUDGET" : "");
+    }
+
+    return over_budget ? 1 : 0;
+}
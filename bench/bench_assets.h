@@ -0,0 +1,16 @@
+#ifndef BENCH_ASSETS_H
+#define BENCH_ASSETS_H
+
+#include <stdint.h>
+
+// Track files embedded at configure time (see bench/CMakeLists.txt)
+typedef struct {
+    const char *name; // "ROM:track01_map.bin"
+    const uint8_t *data;
+    uint16_t size;
+} BenchAsset;
+
+extern const BenchAsset bench_assets[];
+extern const uint8_t bench_asset_count;
+
+#endif // BENCH_ASSETS_H
@@ -0,0 +1,54 @@
+#ifndef BUDGETS_H
+#define BUDGETS_H
+
+#include "cars.h"
+#include "particles.h"
+#include "colliders.h"
+#include "track.h"
+#include "sched.h"
+
+// Worst-case 6502 cycles per call allowed for each kernel.
+// megaracer_bench fails if any recorded call exceeds its budget.
+// A 60 Hz frame on the RP6502 (8 MHz 65C02) is about 133,000 cycles.
+// Kernels that loop over the field scale with NUM_AI_CARS (cars.h).
+//
+// Not calibrated yet: the per-kernel figures below are estimates from
+// reading the code, not mos-sim counts, so they only catch gross
+// regressions. BUDGET_FRAME is the exception: it is the real frame, so
+// the racing-frame row fails as soon as the benched work stops fitting.
+//
+// Calibrating: a budget is the worst case mos-sim measured plus
+// BUDGET_MARGIN_PERCENT, rounded up to BUDGET_ROUND. The bench prints that
+// figure per kernel in its "calibrated" column; copy it here (per car for
+// the scaled kernels, from the 4-car run), set BUDGETS_CALIBRATED, and a
+// later regression past the margin fails the gate.
+#define BUDGETS_CALIBRATED          0
+#define BUDGET_MARGIN_PERCENT       20
+#define BUDGET_ROUND                100
+
+#define BUDGET_GET_TERRAIN_AT        400
+// Probe on a tile a dynamic collider touches: scans every box
+#define BUDGET_TERRAIN_DYN_NEAR     (BUDGET_GET_TERRAIN_AT + 80UL * MAX_COLLIDERS)
+// Probe whose map row isn't cached: one row from XRAM plus the LRU scan
+#define BUDGET_TERRAIN_ROW_MISS     (BUDGET_GET_TERRAIN_AT + 30UL * MAP_WINDOW_TILES + 30UL * TERRAIN_CACHE_ROWS)
+// Per frame, each car near the screen moves onto at most one new row
+#define BUDGET_TERRAIN_PREFETCH     ((300UL + BUDGET_TERRAIN_ROW_MISS) * NUM_CARS)
+// One 8x8-tile chunk: a seek and 8-byte read per row, then 8 XRAM writes.
+// Steps with nothing left to load just scan the window slots.
+#define BUDGET_TRACK_STREAM_STEP    6000
+#define BUDGET_IS_COLLIDING_FAST    4000
+#define BUDGET_ATAN2_8              1500
+#define BUDGET_UPDATE_AI           (16700UL * NUM_AI_CARS)
+#define BUDGET_UPDATE_PLAYER       25000
+// Player vs each AI, then every AI pair
+#define BUDGET_RESOLVE_COLLISIONS  (2500UL * (NUM_AI_CARS + NUM_AI_CARS * (NUM_AI_CARS - 1) / 2))
+#define BUDGET_DRAW_AI_CARS        (1000UL * NUM_AI_CARS)
+// Fixed pool: the same cost however many effects were asked for
+#define BUDGET_UPDATE_PARTICLES    (150UL * PARTICLE_MAX)
+#define BUDGET_DRAW_PARTICLES      (200UL * PARTICLE_MAX)
+// Player, AI, prefetch, collisions, particles and AI sprites together:
+// the frame less the IRQ reserve. The rest of the frame (video, input,
+// camera, HUD) isn't benched, so this is a floor, not the whole story.
+#define BUDGET_FRAME               ((uint32_t)(SCHED_FRAME_UNITS - SCHED_IRQ_RESERVE_UNITS) * SCHED_UNIT_CYCLES)
+
+#endif // BUDGETS_H
@@ -0,0 +1,14 @@
+#ifndef BENCH_FCNTL_H
+#define BENCH_FCNTL_H
+
+// "ROM:" files for the simulator benchmarks come from bench_assets.c
+
+#define O_RDONLY 0x01
+#define O_WRONLY 0x02
+#define O_CREAT  0x10
+#define O_TRUNC  0x20
+#define O_APPEND 0x40
+
+int open(const char *path, int oflag, ...);
+
+#endif // BENCH_FCNTL_H
@@ -0,0 +1,225 @@
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <rp6502.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "bench_assets.h"
+#include "constants.h"
+#include "input.h"
+#include "hud.h"
+#include "sound.h"
+#include "audio.h"
+#include "xram.h"
+#include "track.h"
+#include "sched.h"
+
+// RAM-backed RIA registers
+volatile struct __RIA RIA;
+
+// Globals normally owned by main.c / hud.c / input.c
+unsigned REDRACER_CONFIG = 0x0800;
+unsigned TRACK_CONFIG;
+unsigned TEXT_CONFIG;
+unsigned text_message_addr;
+int16_t next_scroll_x = 0;
+int16_t next_scroll_y = 0;
+uint8_t race_winner = 0;
+
+uint16_t action_held[GAMEPAD_COUNT];
+uint16_t action_pressed[GAMEPAD_COUNT];
+uint16_t action_released[GAMEPAD_COUNT];
+
+int xregn(char device, char channel, unsigned char address, unsigned count, ...) {
+    (void)device; (void)channel; (void)address; (void)count;
+    return 0;
+}
+
+// --- XRAM reads ---
+// There's no room for a 64K shadow, so read_xram() just remembers which
+// embedded asset bytes each load put where, and xram_read() copies from
+// there. Only whole-file loads (track maps) and the streamed map window
+// can be read back.
+
+#define BENCH_XRAM_SEGMENTS 8
+
+typedef struct {
+    uint16_t addr;
+    uint16_t size;
+    const uint8_t *data;
+} XramSegment;
+
+static XramSegment xram_segments[BENCH_XRAM_SEGMENTS];
+static uint8_t next_segment = 0;
+
+static bool file_asset_bytes(int fildes, unsigned count, const uint8_t **data, uint16_t *size);
+
+int read_xram(unsigned buf, unsigned count, int fildes) {
+    const uint8_t *data;
+    uint16_t size;
+    if (!file_asset_bytes(fildes, count, &data, &size)) return 0;
+
+    // A reload at the same address replaces the old contents
+    uint8_t i;
+    for (i = 0; i < BENCH_XRAM_SEGMENTS; i++) {
+        if (xram_segments[i].data && xram_segments[i].addr == buf) break;
+    }
+    if (i == BENCH_XRAM_SEGMENTS) {
+        i = next_segment;
+        next_segment = (next_segment + 1) % BENCH_XRAM_SEGMENTS;
+    }
+    xram_segments[i].addr = buf;
+    xram_segments[i].size = size;
+    xram_segments[i].data = data;
+    return size;
+}
+
+// A streamed track's map window is written a chunk row at a time
+// (xram_write), so it gets a RAM copy of its own
+static uint8_t window_shadow[MAP_WINDOW_TILES * MAP_WINDOW_TILES];
+
+static bool in_window(uint16_t addr, uint16_t count) {
+    return track_streaming && addr >= track_map_xram &&
+           (uint16_t)(addr - track_map_xram) + count <= sizeof(window_shadow);
+}
+
+void xram_write(uint16_t addr, const void* src, uint16_t count) {
+    if (in_window(addr, count)) memcpy(window_shadow + (addr - track_map_xram), src, count);
+}
+
+void xram_read(uint16_t addr, void* dst, uint16_t count) {
+    if (in_window(addr, count)) {
+        memcpy(dst, window_shadow + (addr - track_map_xram), count);
+        return;
+    }
+    memset(dst, 0, count);
+    for (uint8_t i = 0; i < BENCH_XRAM_SEGMENTS; i++) {
+        const XramSegment *s = &xram_segments[i];
+        if (!s->data || addr < s->addr || addr >= s->addr + s->size) continue;
+        uint16_t left = s->addr + s->size - addr;
+        memcpy(dst, s->data + (addr - s->addr), (count < left) ? count : left);
+        return;
+    }
+}
+
+// HUD and audio are not part of the measured kernels
+void hud_print(uint8_t x, uint8_t y, const char* str, uint8_t fg, uint8_t bg) {
+    (void)x; (void)y; (void)str; (void)fg; (void)bg;
+}
+
+void update_countdown_display(uint16_t delay) {
+    (void)delay;
+}
+
+void update_engine_sound(uint16_t velocity_mag) {
+    (void)velocity_mag;
+}
+
+void stop_engine_sound(void) {
+}
+
+bool sound_post(uint8_t type, uint16_t param) {
+    (void)type; (void)param;
+    return true;
+}
+
+// Frame timer on clock(). Unless bench_frame_start() has set a frame, there
+// is always time left, so every AI brain runs and update_ai is measured at
+// its worst case.
+static clock_t frame_start;
+static uint16_t frame_units = 0xFFFF;
+
+void bench_frame_start(uint16_t units) {
+    frame_start = clock();
+    frame_units = units;
+}
+
+uint16_t sched_busy = 0;
+
+uint16_t sched_frame_elapsed(void) {
+    uint32_t units = (uint32_t)(clock() - frame_start) / SCHED_UNIT_CYCLES;
+    return (units < 0xFFFF) ? (uint16_t)units : 0xFFFF;
+}
+
+uint16_t sched_frame_left(void) {
+    if (frame_units == 0xFFFF) return 0xFFFF;
+    uint16_t now = sched_frame_elapsed();
+    return (now + SCHED_IRQ_RESERVE_UNITS < frame_units) ? frame_units - SCHED_IRQ_RESERVE_UNITS - now : 0;
+}
+
+// --- "ROM:" file system over the embedded assets ---
+// Unknown files (e.g. XRAM tiles) open as empty so loaders stay quiet.
+
+#define BENCH_MAX_FILES 4
+#define BENCH_EMPTY_ASSET 0xFF
+
+static uint8_t file_asset[BENCH_MAX_FILES];
+static uint16_t file_pos[BENCH_MAX_FILES];
+static bool file_open[BENCH_MAX_FILES];
+
+int open(const char *path, int oflag, ...) {
+    (void)oflag;
+    for (int fd = 0; fd < BENCH_MAX_FILES; fd++) {
+        if (file_open[fd]) continue;
+
+        file_asset[fd] = BENCH_EMPTY_ASSET;
+        for (uint8_t i = 0; i < bench_asset_count; i++) {
+            if (strcmp(path, bench_assets[i].name) == 0) {
+                file_asset[fd] = i;
+                break;
+            }
+        }
+        file_pos[fd] = 0;
+        file_open[fd] = true;
+        return fd;
+    }
+    return -1;
+}
+
+int read(int fildes, void *buf, unsigned count) {
+    if (fildes < 0 || fildes >= BENCH_MAX_FILES || !file_open[fildes]) return -1;
+    if (file_asset[fildes] == BENCH_EMPTY_ASSET) return 0;
+
+    const BenchAsset *asset = &bench_assets[file_asset[fildes]];
+    if (file_pos[fildes] >= asset->size) return 0; // Seeked past the end
+    unsigned left = asset->size - file_pos[fildes];
+    if (count > left) count = left;
+    memcpy(buf, asset->data + file_pos[fildes], count);
+    file_pos[fildes] += count;
+    return count;
+}
+
+// Where a read of count bytes would come from, advancing the file position
+static bool file_asset_bytes(int fildes, unsigned count, const uint8_t **data, uint16_t *size) {
+    if (fildes < 0 || fildes >= BENCH_MAX_FILES || !file_open[fildes]) return false;
+    if (file_asset[fildes] == BENCH_EMPTY_ASSET) return false;
+
+    const BenchAsset *asset = &bench_assets[file_asset[fildes]];
+    if (file_pos[fildes] >= asset->size) return false;
+    unsigned left = asset->size - file_pos[fildes];
+    if (count > left) count = left;
+    *data = asset->data + file_pos[fildes];
+    *size = count;
+    file_pos[fildes] += count;
+    return true;
+}
+
+// Writes (the log file) go nowhere
+int write(int fildes, const void *buf, unsigned count) {
+    (void)buf;
+    if (fildes < 0 || fildes >= BENCH_MAX_FILES || !file_open[fildes]) return -1;
+    return count;
+}
+
+int close(int fildes) {
+    if (fildes < 0 || fildes >= BENCH_MAX_FILES) return -1;
+    file_open[fildes] = false;
+    return 0;
+}
+
+off_t lseek(int fildes, off_t offset, int whence) {
+    if (fildes < 0 || fildes >= BENCH_MAX_FILES || !file_open[fildes]) return -1;
+    if (whence == SEEK_SET) file_pos[fildes] = offset;
+    else if (whence == SEEK_CUR) file_pos[fildes] += offset;
+    return file_pos[fildes];
+}
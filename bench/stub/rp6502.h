@@ -0,0 +1,64 @@
+#ifndef BENCH_RP6502_H
+#define BENCH_RP6502_H
+
+// Minimal RIA stand-in for the simulator benchmarks.
+// RIA is a plain volatile struct in RAM, so XRAM port writes still cost a
+// store each but go nowhere. Only what the benchmarked sources use is here.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct __RIA {
+    uint8_t ready;
+    uint8_t tx;
+    uint8_t rx;
+    uint8_t vsync;
+    uint8_t rw0;
+    uint8_t step0;
+    uint16_t addr0;
+    uint8_t rw1;
+    uint8_t step1;
+    uint16_t addr1;
+};
+
+extern volatile struct __RIA RIA;
+
+typedef struct {
+    int16_t transform[6];
+    int16_t x_pos_px;
+    int16_t y_pos_px;
+    int16_t xram_sprite_ptr;
+    uint8_t log_size;
+    bool has_opacity_metadata;
+} vga_mode4_asprite_t;
+
+typedef struct {
+    int16_t x_pos_px;
+    int16_t y_pos_px;
+    uint16_t xram_sprite_ptr;
+    uint8_t log_size;
+    bool has_opacity_metadata;
+} vga_mode4_sprite_t;
+
+typedef struct {
+    bool x_wrap;
+    bool y_wrap;
+    int16_t x_pos_px;
+    int16_t y_pos_px;
+    int16_t width_tiles;
+    int16_t height_tiles;
+    uint16_t xram_data_ptr;
+    uint16_t xram_palette_ptr;
+    uint16_t xram_tile_ptr;
+} vga_mode2_config_t;
+
+#define xram0_struct_set(addr, type, member, val)                   \
+    do {                                                            \
+        RIA.addr0 = (unsigned)(addr) + __builtin_offsetof(type, member); \
+        RIA.rw0 = (uint8_t)(val);                                   \
+    } while (0)
+
+int xregn(char device, char channel, unsigned char address, unsigned count, ...);
+int read_xram(unsigned buf, unsigned count, int fildes);
+
+#endif // BENCH_RP6502_H
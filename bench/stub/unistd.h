@@ -0,0 +1,15 @@
+#ifndef BENCH_UNISTD_H
+#define BENCH_UNISTD_H
+
+typedef long off_t;
+
+#define SEEK_SET 0
+#define SEEK_CUR 1
+#define SEEK_END 2
+
+int read(int fildes, void *buf, unsigned count);
+int write(int fildes, const void *buf, unsigned count);
+int close(int fildes);
+off_t lseek(int fildes, off_t offset, int whence);
+
+#endif // BENCH_UNISTD_H
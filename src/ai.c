@@ -7,6 +7,9 @@
 #include "racelogic.h"
 #include "hud.h"
 #include "input.h"
+#include "sched.h"
+#include "particles.h"
+#include "pacing.h"
 #include <stdio.h>
 
 #define AI_TURN_SPEED 3
@@ -53,39 +56,251 @@ uint8_t atan2_8(int16_t dy, int16_t dx) {
     return 256 - angle;
 }
 
-AICar ai_cars[NUM_AI_CARS];
+int8_t ai_offset_x[NUM_CARS];
+int8_t ai_offset_y[NUM_CARS];
+uint8_t ai_stuck_timer[NUM_CARS];
+int16_t ai_last_x[NUM_CARS];
+int16_t ai_last_y[NUM_CARS];
+uint8_t ai_target_angle[NUM_CARS];
+uint8_t ai_base_speed_shift[NUM_CARS];
+uint8_t ai_thrust_shift[NUM_CARS];
+uint8_t ai_think_age[NUM_CARS];
+static uint8_t ai_rubber_age[NUM_CARS]; // Frames since the last pace update
+static bool ai_lod[NUM_CARS];            // Moved without terrain last frame
+uint16_t ai_brains_run = 0;
+uint16_t ai_brains_forced = 0;
 
 Waypoint waypoints[NUM_WAYPOINTS];
 
 void init_ai(void) {
-    int16_t start_positions[NUM_AI_CARS] = {40, 50, 60};  
-    for (uint8_t i = 0; i < NUM_AI_CARS; i++) {
-        ai_cars[i].car.x = 245 << 6;  // 10.6 init
-        ai_cars[i].car.y = start_positions[i] << 6;
-        ai_cars[i].car.vel_x = 0;
-        ai_cars[i].car.vel_y = 0;
-        ai_cars[i].car.angle = 64;  
-        ai_cars[i].car.current_waypoint = 1;  
-        ai_cars[i].sprite_index = i + 1;  
-        ai_cars[i].last_recorded_x = 245;  
-        ai_cars[i].last_recorded_y = start_positions[i];
-        ai_cars[i].base_speed_shift = AI_SPEED_NORMAL;
-        ai_cars[i].last_thrust_shift = AI_SPEED_NORMAL;
+    for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+        int16_t start_y = 30 + 10 * i; // 40, 50, 60, ...
+        reset_car(i, 245, start_y, 64);
+        ai_last_x[i] = 245;
+        ai_last_y[i] = start_y;
+        ai_base_speed_shift[i] = AI_SPEED_NORMAL;
+        ai_thrust_shift[i] = AI_SPEED_NORMAL;
+        // Staggered so forced thinks spread over frames
+        ai_think_age[i] = i - FIRST_AI_SLOT;
+        ai_rubber_age[i] = 0;
+        ai_lod[i] = false;
     }
-    car.total_progress = 0;
-    car.current_waypoint = 1;
+    ai_brains_run = 0;
+    ai_brains_forced = 0;
+    car_waypoint[PLAYER_SLOT] = 1;
 }
 
-static uint8_t ai_brain_turn = 0; // Rotates 0, 1, 2
+// --- Brain scheduling ---
+// Thinking (steering target, waypoint, stuck check, rubberbanding) is the
+// costly part of the AI; physics runs for every car every frame. update_ai
+// thinks for as many cars as the measured frame time allows, best
+// candidates first, and any car that has gone AI_MAX_THINK_AGE frames
+// without a think gets one regardless, so a heavy frame degrades to the old
+// one-car-per-frame round robin and never below it.
+//
+// The costs it plans with are measured as the race runs, in scheduler units
+// (256 cycles) times AI_COST_ONE: a think, a car's physics on and off
+// screen (LOD), and the stages after update_ai from the last frame's pacing
+// marks. Each jumps to a new worst at once and eases back by an eighth of
+// the difference per sample, so a spike is covered for a while without
+// holding the brains back for the rest of the race.
+#define AI_MAX_THINK_AGE   NUM_AI_CARS
+#define AI_SCREEN_BONUS    4      // Priority for a car the player can see...
+#define AI_NEAR_BONUS      2      // ...and more when it is close enough to race
+#define AI_NEAR_PIXELS     64
+#define AI_STUCK_FRAMES    90     // Stuck check interval
+#define AI_RUBBER_FRAMES   16     // Pace recalculation interval
+#define AI_COST_ONE        8      // Fixed point: the costs are in 1/8 units
+#define AI_COST_UNKNOWN    0xFFFF // Not measured yet: no optional brains
+
+static uint16_t cost_think = AI_COST_UNKNOWN;
+static uint16_t cost_physics[2] = {AI_COST_UNKNOWN, AI_COST_UNKNOWN}; // [lod]
+static uint16_t cost_after = AI_COST_UNKNOWN; // Collisions, logic, camera, HUD, sprites
+
+static void cost_sample(uint16_t* cost, uint16_t t0, uint16_t t1) {
+    if (t1 < t0) return; // The vsync IRQ restarted the frame timer in between
+    uint16_t sample = (t1 - t0) * AI_COST_ONE;
+    if (*cost == AI_COST_UNKNOWN || sample >= *cost) *cost = sample;
+    else *cost -= (*cost - sample) >> 3;
+}
 
-void update_ai(void) {
-    // Manage which AI car gets to "think" this frame
-    if (++ai_brain_turn >= NUM_AI_CARS) ai_brain_turn = 0;
 
+static void ai_think(uint8_t i, uint8_t age) {
+    uint16_t x = CAR_POS(car_x, i);
+    uint16_t y = CAR_POS(car_y, i);
+    int16_t car_px_x = x >> 6;
+    int16_t car_px_y = y >> 6;
+    uint8_t wp = car_waypoint[i];
+
+    // --- PACE ---
+    ai_rubber_age[i] += age;
+    if (ai_rubber_age[i] >= AI_RUBBER_FRAMES) {
+        ai_rubber_age[i] = 0;
+        if (current_state == STATE_RACING) update_ai_rubberbanding(i);
+    }
+
+    // --- STUCK DETECTION & RESCUE ---
+    ai_stuck_timer[i] += age;
+    if (ai_stuck_timer[i] >= AI_STUCK_FRAMES) {
+        ai_stuck_timer[i] = 0;
+
+        // If the car moved less than 3 pixels since the last check
+        if (abs(car_px_x - ai_last_x[i]) < 3 && abs(car_px_y - ai_last_y[i]) < 3) {
+
+            // --- RESCUE TELEPORT ---
+            // Find the waypoint they just came from
+            uint8_t prev_wp = (wp == 0) ? (g_num_active_waypoints - 1) : (wp - 1);
+
+            // Snap to the center of the previous waypoint
+            car_px_x = waypoints[prev_wp].x;
+            car_px_y = waypoints[prev_wp].y;
+            CAR_SET16(car_x, i, (uint16_t)car_px_x << 6);
+            CAR_SET16(car_y, i, (uint16_t)car_px_y << 6);
+
+            // Reset physics so they don't carry "wall-stuck" velocity to the new spot
+            CAR_SET16(car_vx, i, 0);
+            CAR_SET16(car_vy, i, 0);
+            car_rebound[i] = 0;
+        }
+
+        // Update tracker for the next check
+        ai_last_x[i] = car_px_x;
+        ai_last_y[i] = car_px_y;
+    }
+
+    // --- WAYPOINT UPDATING ---
+    int16_t dx = waypoints[wp].x + ai_offset_x[i] - car_px_x;
+    int16_t dy = waypoints[wp].y + ai_offset_y[i] - car_px_y;
+
+    // Manhattan distance for VSync speed. Off screen, update_ai moves the
+    // waypoint on when the car actually gets there.
+    if (!ai_lod[i] && (abs(dx) + abs(dy)) < 50) {
+        wp++;
+        if (wp >= g_num_active_waypoints) {
+            wp = 0;
+        }
+        car_waypoint[i] = wp;
+    }
+
+    uint8_t target_angle = (192 - atan2_8(dy, dx)) & 0xFF;
+    ai_target_angle[i] = target_angle;
+
+    uint8_t angle_diff = abs((int8_t)(target_angle - car_angle[i]));
+    uint8_t shift = ai_base_speed_shift[i];
+
+    if (angle_diff > 48) {
+        // Sharp Turn: Slow down significantly (2 tiers)
+        shift += 2;
+    } else if (angle_diff > 24) {
+        // Moderate Turn: Slow down slightly (1 tier)
+        shift += 1;
+    }
+
+    // Safety cap: Never go slower than Shift 5
+    if (shift > AI_SPEED_SLOW) {
+        shift = AI_SPEED_SLOW;
+    }
+    ai_thrust_shift[i] = shift;
+}
+
+// --- Level of detail ---
+// Off screen (plus a margin so the switch is never seen) AI cars keep the
+// same thrust and friction but no terrain: update_ai moves them along the
+// waypoint line their brains steer along, without any get_terrain_at calls.
+#define AI_LOD_MARGIN 32
+
+static bool ai_in_view(uint16_t x, uint16_t y) {
+    extern int16_t next_scroll_x, next_scroll_y;
+    int16_t sx = (x >> 6) + next_scroll_x;
+    int16_t sy = (y >> 6) + next_scroll_y;
+    return sx > -16 - AI_LOD_MARGIN && sx < SCREEN_WIDTH + AI_LOD_MARGIN &&
+           sy > -16 - AI_LOD_MARGIN && sy < SCREEN_HEIGHT + AI_LOD_MARGIN;
+}
+
+// Cars waiting longest, then on screen, then close to the player go first
+static uint8_t think_priority(uint8_t i) {
+    int16_t dx = (int16_t)(CAR_POS(car_x, i) >> 6) - (int16_t)(CAR_POS(car_x, PLAYER_SLOT) >> 6);
+    int16_t dy = (int16_t)(CAR_POS(car_y, i) >> 6) - (int16_t)(CAR_POS(car_y, PLAYER_SLOT) >> 6);
+    dx = abs(dx);
+    dy = abs(dy);
+
+    uint8_t prio = ai_think_age[i];
+    if (dx < SCREEN_WIDTH / 2 && dy < SCREEN_HEIGHT / 2) {
+        prio += AI_SCREEN_BONUS;
+        if (dx + dy < AI_NEAR_PIXELS) prio += AI_NEAR_BONUS;
+    }
+    return prio;
+}
+
+// A brain, timed into cost_think
+static void ai_think_timed(uint8_t i) {
+    uint16_t t0 = sched_frame_elapsed();
+    ai_think(i, ai_think_age[i]);
+    cost_sample(&cost_think, t0, sched_frame_elapsed());
+    ai_think_age[i] = 0;
+    ai_brains_run++;
+}
+
+// What the rest of the frame still needs after one more brain: every AI
+// car's physics at the cost of the path it took last frame, and the stages
+// after update_ai. AI_COST_UNKNOWN while any of it hasn't been measured.
+static uint16_t frame_cost_after_think(void) {
+    if (cost_think == AI_COST_UNKNOWN || cost_after == AI_COST_UNKNOWN) return AI_COST_UNKNOWN;
+    uint16_t cost = cost_think + cost_after;
+    for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+        uint16_t physics = cost_physics[ai_lod[i]];
+        if (physics == AI_COST_UNKNOWN) return AI_COST_UNKNOWN;
+        cost += physics;
+    }
+    return cost;
+}
+
+static void ai_schedule_brains(void) {
+    uint8_t thought = 0; // Bit per AI car (slot - FIRST_AI_SLOT)
+
+    // Last frame's collision and logic stages, now that they have run
+    cost_sample(&cost_after, 0, pacing_prev_units[PACE_COLLIDE] + pacing_prev_units[PACE_LOGIC]);
+
+    // Overdue cars think no matter what the frame costs
+    for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+        if (ai_think_age[i] < 0xFF) ai_think_age[i]++;
+        if (ai_think_age[i] >= AI_MAX_THINK_AGE) {
+            ai_think_timed(i);
+            thought |= 1 << (i - FIRST_AI_SLOT);
+            ai_brains_forced++;
+        }
+    }
+
+    // Then the best remaining candidate while the frame has room for it
+    // and everything that still has to run after it
+    uint16_t need = frame_cost_after_think();
+    if (need == AI_COST_UNKNOWN) return;
+    need = (need + AI_COST_ONE - 1) / AI_COST_ONE;
+    for (;;) {
+        if (sched_frame_left() < need) break;
+
+        int8_t pick = -1;
+        uint8_t best = 0;
+        for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+            if (thought & (1 << (i - FIRST_AI_SLOT))) continue;
+            uint8_t prio = think_priority(i);
+            if (pick < 0 || prio > best) {
+                pick = i;
+                best = prio;
+            }
+        }
+        if (pick < 0) break;
+
+        ai_think_timed(pick);
+        thought |= 1 << (pick - FIRST_AI_SLOT);
+    }
+}
+
+void update_ai(void) {
     // Check for the Start Trigger
     if (!countdown_active) {
         hud_print(13, 5, " PRESS FIRE TO START ", HUD_COL_WHITE, HUD_COL_BG);
-        if (is_action_pressed(0, ACTION_FIRE)) {
+        if (is_action_just_pressed(0, ACTION_FIRE)) {
             countdown_active = true;
             // Clear the "Press Fire" message
             hud_print(13, 5, "                     ", 0, 0);
@@ -99,123 +314,83 @@ void update_ai(void) {
         update_countdown_display(state_timer);
     }
 
-    for (uint8_t i = 0; i < NUM_AI_CARS; i++) {
-        AICar *ai = &ai_cars[i];
-        // AI remains stationary unless racing
+    // AI remains stationary unless racing
+    if (state_timer <= 300) ai_schedule_brains();
+
+    for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
         // If the countdown is still running, AI stays still
         if (state_timer > 300) {
             // Optional: reset velocity here to ensure they don't creep
-            ai->car.vel_x = 0;
-            ai->car.vel_y = 0;
+            CAR_SET16(car_vx, i, 0);
+            CAR_SET16(car_vy, i, 0);
             continue;
         }
+        uint16_t t0 = sched_frame_elapsed();
+
+        // Work on locals; written back to the slot arrays at the end
+        uint16_t x = CAR_POS(car_x, i);
+        uint16_t y = CAR_POS(car_y, i);
+        int16_t vel_x = CAR_GET16(car_vx, i);
+        int16_t vel_y = CAR_GET16(car_vy, i);
+        uint8_t angle = car_angle[i];
+        uint8_t rebound = car_rebound[i];
 
         // --- 1. REBOUND TIMER (Every Frame) ---
         // We keep this so they still "stun" when hitting things
-        if (ai->rebound_timer > 0) ai->rebound_timer--;
-
-        // --- 2. BRAIN (1 of 3 cars per frame) ---
-        if (i == ai_brain_turn) {
-            int16_t car_px_x = ai->car.x >> 6;
-            int16_t car_px_y = ai->car.y >> 6;
-
-            // --- STUCK DETECTION & RESCUE ---
-            ai->stuck_timer++;
-            if (ai->stuck_timer >= 30) {
-                ai->stuck_timer = 0;
-                
-                // If the car moved less than 3 pixels in the last 30 frames
-                if (abs(car_px_x - ai->last_recorded_x) < 3 && abs(car_px_y - ai->last_recorded_y) < 3) {
-                    
-                    // --- RESCUE TELEPORT ---
-                    // Find the waypoint they just came from
-                    uint8_t prev_wp = (ai->car.current_waypoint == 0) ? (g_num_active_waypoints - 1) : (ai->car.current_waypoint - 1);
-                    
-                    // Snap to the center of the previous waypoint
-                    ai->car.x = (uint16_t)waypoints[prev_wp].x << 6;
-                    ai->car.y = (uint16_t)waypoints[prev_wp].y << 6;
-                    
-                    // Reset physics so they don't carry "wall-stuck" velocity to the new spot
-                    ai->car.vel_x = 0;
-                    ai->car.vel_y = 0;
-                    ai->rebound_timer = 0;
-                }
-                
-                // Update tracker for the next check
-                ai->last_recorded_x = car_px_x;
-                ai->last_recorded_y = car_px_y;
-            }
+        if (rebound > 0) rebound--;
 
-            // --- WAYPOINT UPDATING ---
-            int16_t dx = waypoints[ai->car.current_waypoint].x + ai->offset_x - car_px_x;
-            int16_t dy = waypoints[ai->car.current_waypoint].y + ai->offset_y - car_px_y;
-            
-            // Manhattan distance for VSync speed
-            if ((abs(dx) + abs(dy)) < 50) {
-                ai->car.progress_steps++; // This never resets!
-                ai->car.current_waypoint++;
-                if (ai->car.current_waypoint >= g_num_active_waypoints) {
-                    ai->car.current_waypoint = 0;
-                }
-            }
-            
-            ai->target_angle = (192 - atan2_8(dy, dx)) & 0xFF;
-
-            // Inside update_ai -> brain turn (if i == ai_brain_turn)
-            uint8_t angle_diff = abs((int8_t)(ai->target_angle - ai->car.angle));
-
-            if (angle_diff > 48) {
-                // Sharp Turn: Slow down significantly (2 tiers)
-                ai->last_thrust_shift = ai->base_speed_shift + 2;
-            } else if (angle_diff > 24) {
-                // Moderate Turn: Slow down slightly (1 tier)
-                ai->last_thrust_shift = ai->base_speed_shift + 1;
-            } else {
-                // Straight: Full speed
-                ai->last_thrust_shift = ai->base_speed_shift;
-            }
-
-            // Safety cap: Never go slower than Shift 5
-            if (ai->last_thrust_shift > AI_SPEED_SLOW) {
-                ai->last_thrust_shift = AI_SPEED_SLOW;
-            }
+        // --- 2. BRAIN --- (ai_schedule_brains, above)
 
+        // --- 3. PHYSICS (Every Frame) ---
+        // Off screen, skip every terrain probe. A car coming back into view
+        // stays on the path until it is clear of walls.
+        bool lod = !ai_in_view(x, y);
+        if (!lod && ai_lod[i] && is_colliding_ai(x >> 6, y >> 6)) lod = true;
+        bool lod_entry = lod && !ai_lod[i];
+        if (lod_entry) {
+            // The brain turns for the next waypoint 50 pixels early; going
+            // straight there from here could clip the corner, so go back
+            // through the one it just passed
+            uint8_t prev = car_waypoint[i] ? car_waypoint[i] - 1 : g_num_active_waypoints - 1;
+            int16_t px = waypoints[prev].x + ai_offset_x[i] - (int16_t)(x >> 6);
+            int16_t py = waypoints[prev].y + ai_offset_y[i] - (int16_t)(y >> 6);
+            if ((abs(px) + abs(py)) < 50) car_waypoint[i] = prev;
         }
+        ai_lod[i] = lod;
 
-        // --- 3. PHYSICS (Every Frame) ---
         // Turn toward target
         if (state_timer < 270) { // Make a clean start after countdown
-            uint8_t diff = ai->target_angle - ai->car.angle;
+            uint8_t diff = ai_target_angle[i] - angle;
             if (diff != 0) {
-                if (diff < 128) ai->car.angle += AI_TURN_SPEED;
-                else ai->car.angle -= AI_TURN_SPEED;
+                if (diff < 128) angle += AI_TURN_SPEED;
+                else angle -= AI_TURN_SPEED;
 
                 // --- ROTATION EJECTOR ---
                 // If rotating pushed us into a wall, shove out
-                int8_t s = SIN_LUT[ai->car.angle];
-                int8_t c = SIN_LUT[(ai->car.angle + 64) & 0xFF];
+                int8_t s = SIN_LUT[angle];
+                int8_t c = SIN_LUT[(angle + 64) & 0xFF];
 
-                int16_t test_x = ai->car.x >> 6;
-                int16_t test_y = ai->car.y >> 6;
+                int16_t test_x = x >> 6;
+                int16_t test_y = y >> 6;
 
-                if (is_colliding_ai(test_x, test_y)) {
+                if (!lod && is_colliding_ai(test_x, test_y)) {
                     // Smart Ejector: Try Backward first, then Forward
                     // s/c are ~2 pixels magnitude (127/64)
                     
-                    int16_t back_x = ai->car.x + (int16_t)s;
-                    int16_t back_y = ai->car.y + (int16_t)c;
+                    uint16_t back_x = x + (int16_t)s;
+                    uint16_t back_y = y + (int16_t)c;
                     
                     if (!is_colliding_ai(back_x >> 6, back_y >> 6)) {
-                        ai->car.x = back_x;
-                        ai->car.y = back_y;
+                        x = back_x;
+                        y = back_y;
                     } else {
                         // Backend blocked? Try pushing blocked nose out (Forward)
-                        int16_t fwd_x = ai->car.x - (int16_t)s;
-                        int16_t fwd_y = ai->car.y - (int16_t)c;
+                        uint16_t fwd_x = x - (int16_t)s;
+                        uint16_t fwd_y = y - (int16_t)c;
                         
                         if (!is_colliding_ai(fwd_x >> 6, fwd_y >> 6)) {
-                            ai->car.x = fwd_x;
-                            ai->car.y = fwd_y;
+                            x = fwd_x;
+                            y = fwd_y;
                         }
                     }
                 }
@@ -223,62 +398,119 @@ void update_ai(void) {
         }
 
         // Thrust
-        if (ai->rebound_timer == 0) {
-            int8_t s = SIN_LUT[ai->car.angle];
-            int8_t c = SIN_LUT[(ai->car.angle + 64) & 0xFF];
-            ai->car.vel_x -= (int16_t)s >> ai->last_thrust_shift;
-            ai->car.vel_y -= (int16_t)c >> ai->last_thrust_shift;
+        if (rebound == 0) {
+            int8_t s = SIN_LUT[angle];
+            int8_t c = SIN_LUT[(angle + 64) & 0xFF];
+            vel_x -= (int16_t)s >> ai_thrust_shift[i];
+            vel_y -= (int16_t)c >> ai_thrust_shift[i];
         }
 
         // Friction
-        int16_t dvx = (ai->car.vel_x >> FRICTION_SHIFT);
-        int16_t dvy = (ai->car.vel_y >> FRICTION_SHIFT);
-        if (dvx == 0 && ai->car.vel_x != 0) dvx = (ai->car.vel_x > 0) ? 1 : -1;
-        if (dvy == 0 && ai->car.vel_y != 0) dvy = (ai->car.vel_y > 0) ? 1 : -1;
-        ai->car.vel_x -= dvx; 
-        ai->car.vel_y -= dvy;
+        int16_t dvx = (vel_x >> FRICTION_SHIFT);
+        int16_t dvy = (vel_y >> FRICTION_SHIFT);
+        if (dvx == 0 && vel_x != 0) dvx = (vel_x > 0) ? 1 : -1;
+        if (dvy == 0 && vel_y != 0) dvy = (vel_y > 0) ? 1 : -1;
+        vel_x -= dvx; 
+        vel_y -= dvy;
 
         // --- 4. MOVEMENT & WALL COLLISION ---
-        int16_t px = (int16_t)(ai->car.x >> 6);
-        int16_t py = (int16_t)(ai->car.y >> 6);
-
-        if (ai->car.vel_x != 0) {
-            int16_t dx_10_6 = ai->car.vel_x >> 2;
-            int16_t nx = (int16_t)((ai->car.x + dx_10_6) >> 6);
-            if (is_colliding_ai(nx, py)) {
-                ai->car.vel_x = (ai->car.vel_x > 0) ? -BOUNCE_IMPULSE : BOUNCE_IMPULSE;
-                ai->car.x += (ai->car.vel_x > 0 ? PUSH_OUT_10_6 : -PUSH_OUT_10_6);
-                ai->rebound_timer = REBOUND_STUN;
-            } else {
-                ai->car.x += dx_10_6;
-                px = nx;
+        if (lod) {
+            // Off screen the car runs on the waypoint line instead of the
+            // terrain: it faces its waypoint, keeps only the speed it carries
+            // along that line and only moves on once it is exactly there, so
+            // it can't cut through a wall or a corner to gain places.
+            uint8_t wp = car_waypoint[i];
+            int16_t dx = waypoints[wp].x + ai_offset_x[i] - (int16_t)(x >> 6);
+            int16_t dy = waypoints[wp].y + ai_offset_y[i] - (int16_t)(y >> 6);
+            if (dx == 0 && dy == 0) {
+                if (++wp >= g_num_active_waypoints) wp = 0;
+                car_waypoint[i] = wp;
+                dx = waypoints[wp].x + ai_offset_x[i] - (int16_t)(x >> 6);
+                dy = waypoints[wp].y + ai_offset_y[i] - (int16_t)(y >> 6);
             }
-        }
-        if (ai->car.vel_y != 0) {
-            int16_t dy_10_6 = ai->car.vel_y >> 2;
-            int16_t ny = (int16_t)((ai->car.y + dy_10_6) >> 6);
-            if (is_colliding_ai(px, ny)) {
-                ai->car.vel_y = (ai->car.vel_y > 0) ? -BOUNCE_IMPULSE : BOUNCE_IMPULSE;
-                ai->car.y += (ai->car.vel_y > 0 ? PUSH_OUT_10_6 : -PUSH_OUT_10_6);
-                ai->rebound_timer = REBOUND_STUN;
-            } else {
-                ai->car.y += dy_10_6;
+            uint8_t heading = (192 - atan2_8(dy, dx)) & 0xFF;
+            ai_target_angle[i] = heading;
+            if (heading != angle || lod_entry) {
+                // Swing the velocity onto the new heading: the speed along
+                // the way the car faces (velocity dotted with it; the LUT's
+                // 127 for 128 twice is put back by the >> 6), less a share
+                // for how sharply it turns
+                int8_t s = SIN_LUT[angle];
+                int8_t c = SIN_LUT[(angle + 64) & 0xFF];
+                int16_t speed = -(int16_t)(((int32_t)vel_x * s + (int32_t)vel_y * c) >> 7);
+                if (speed < 0) speed = 0;
+                uint8_t turn = abs((int8_t)(heading - angle));
+                speed += speed >> 6;
+                speed -= (int16_t)(((int32_t)speed * turn) >> 8);
+
+                angle = heading;
+                s = SIN_LUT[angle];
+                c = SIN_LUT[(angle + 64) & 0xFF];
+                vel_x = -(int16_t)(((int32_t)speed * s) >> 7);
+                vel_y = -(int16_t)(((int32_t)speed * c) >> 7);
+            }
+
+            // Never past the waypoint in one step
+            int16_t step_x = vel_x >> 2;
+            int16_t step_y = vel_y >> 2;
+            if (abs(dx) < 16 && abs(step_x) > abs(dx) << 6) step_x = dx << 6;
+            if (abs(dy) < 16 && abs(step_y) > abs(dy) << 6) step_y = dy << 6;
+            x += step_x;
+            y += step_y;
+        } else {
+            int16_t px = (int16_t)(x >> 6);
+            int16_t py = (int16_t)(y >> 6);
+
+            if (vel_x != 0) {
+                int16_t dx_10_6 = vel_x >> 2;
+                int16_t nx = (int16_t)((x + dx_10_6) >> 6);
+                if (is_colliding_ai(nx, py)) {
+                    vel_x = (vel_x > 0) ? -BOUNCE_IMPULSE : BOUNCE_IMPULSE;
+                    x += (vel_x > 0 ? PUSH_OUT_10_6 : -PUSH_OUT_10_6);
+                    rebound = REBOUND_STUN;
+                    particle_spawn(PART_SPARK, (x >> 6) + 8, (y >> 6) + 8, 2);
+                } else {
+                    x += dx_10_6;
+                    px = nx;
+                }
+            }
+            if (vel_y != 0) {
+                int16_t dy_10_6 = vel_y >> 2;
+                int16_t ny = (int16_t)((y + dy_10_6) >> 6);
+                if (is_colliding_ai(px, ny)) {
+                    vel_y = (vel_y > 0) ? -BOUNCE_IMPULSE : BOUNCE_IMPULSE;
+                    y += (vel_y > 0 ? PUSH_OUT_10_6 : -PUSH_OUT_10_6);
+                    rebound = REBOUND_STUN;
+                    particle_spawn(PART_SPARK, (x >> 6) + 8, (y >> 6) + 8, 2);
+                } else {
+                    y += dy_10_6;
+                }
             }
         }
 
-        // Clamp world bounds (10.6: 512*64 = 32768, 384*64 = 24576)
-        if (ai->car.x < 0x200) ai->car.x = 0x200;
-        if (ai->car.x > 32768 - 0x200) ai->car.x = 32768 - 0x200;
-        if (ai->car.y < 0x200) ai->car.y = 0x200;
-        if (ai->car.y > 24576 - 0x200) ai->car.y = 24576 - 0x200;
+        // Clamp world bounds (10.6, sized by the loaded track)
+        if (x < WORLD_MIN_10_6) x = WORLD_MIN_10_6;
+        if (x > world_max_x) x = world_max_x;
+        if (y < WORLD_MIN_10_6) y = WORLD_MIN_10_6;
+        if (y > world_max_y) y = world_max_y;
+
+        CAR_SET16(car_x, i, x);
+        CAR_SET16(car_y, i, y);
+        CAR_SET16(car_vx, i, vel_x);
+        CAR_SET16(car_vy, i, vel_y);
+        car_angle[i] = angle;
+        car_rebound[i] = rebound;
+        cost_sample(&cost_physics[lod], t0, sched_frame_elapsed());
     }
 }
 
 // Optimized Sequential Writes for AI
 void draw_ai_cars(int16_t scroll_x, int16_t scroll_y) {
-    for (uint8_t i = 0; i < NUM_AI_CARS; i++) {
-        AICar *ai = &ai_cars[i];
-        uint8_t ang = ai->car.angle;
+    // Sprite configs are laid out by car slot, so the write address just steps
+    unsigned config = REDRACER_CONFIG + sizeof(vga_mode4_asprite_t) * FIRST_AI_SLOT;
+
+    for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+        uint8_t ang = car_angle[i];
         
         int16_t s = (int16_t)SIN_LUT[ang] << 1;
         int16_t c = (int16_t)SIN_LUT[(ang + 64) & 0xFF] << 1;
@@ -286,11 +518,12 @@ void draw_ai_cars(int16_t scroll_x, int16_t scroll_y) {
         int16_t ty = TY_LUT[ang];
         
         // Pixel coordinates (10.6 >> 6)
-        int16_t sx = (int16_t)(ai->car.x >> 6) + scroll_x;
-        int16_t sy = (int16_t)(ai->car.y >> 6) + scroll_y;
+        int16_t sx = (CAR_POS(car_x, i) >> 6) + scroll_x;
+        int16_t sy = (CAR_POS(car_y, i) >> 6) + scroll_y;
 
-        RIA.addr0 = REDRACER_CONFIG + (sizeof(vga_mode4_asprite_t) * ai->sprite_index);
+        RIA.addr0 = config;
         RIA.step0 = 1;
+        config += sizeof(vga_mode4_asprite_t);
 
         RIA.rw0 = c & 0xFF;    RIA.rw0 = c >> 8;     // SX
         RIA.rw0 = (-s) & 0xFF; RIA.rw0 = (-s) >> 8;  // SHY
@@ -304,29 +537,18 @@ void draw_ai_cars(int16_t scroll_x, int16_t scroll_y) {
 }
 
 
-void update_ai_rubberbanding(AICar *ai) {
-    // static int16_t last_diff[3] = {0,0,0};
-    
-    // Calculate difference using the monotonic counters
-    int16_t diff = (int16_t)car.progress_steps - (int16_t)ai->car.progress_steps;
+void update_ai_rubberbanding(uint8_t slot) {
+    // Calculate difference in pixels along the racing line
+    int16_t diff = car_race_progress[PLAYER_SLOT] - car_race_progress[slot];
 
     // diff > 0: Player is ahead (AI Speeds up)
     // diff < 0: AI is ahead (AI Slows down)
 
-    if (diff > 1) {
-        ai->base_speed_shift = AI_SPEED_FAST; // 2
-    } else if (diff < -1) {
-        ai->base_speed_shift = AI_SPEED_SLOW;      // 4
+    if (diff > RUBBERBAND_GAP) {
+        ai_base_speed_shift[slot] = AI_SPEED_FAST; // 2
+    } else if (diff < -RUBBERBAND_GAP) {
+        ai_base_speed_shift[slot] = AI_SPEED_SLOW;      // 4
     } else {
-        ai->base_speed_shift = AI_SPEED_NORMAL;    // 3
+        ai_base_speed_shift[slot] = AI_SPEED_NORMAL;    // 3
     }
-
-    // Diagnostic logging (No more lap glitches!)
-    // uint8_t id = ai->sprite_index - 1;
-    // if (diff != last_diff[id]) {
-    //     printf("Car %d: Diff %d | Shift %d | P_Steps: %d | AI_Steps: %d\n", 
-    //            id, diff, ai->base_speed_shift, car.progress_steps, ai->car.progress_steps);
-    //     last_diff[id] = diff;
-    // }
 }
-
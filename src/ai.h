@@ -9,10 +9,10 @@
 #define AI_SPEED_NORMAL    3  // Standard
 #define AI_SPEED_SLOW      4  // Letting player catch up
 
-#define NUM_AI_CARS 3
 #define NUM_WAYPOINTS 64
 #define WAYPOINT_REACH_RADIUS 40
 #define WAYPOINT_LOOKAHEAD 10
+#define RUBBERBAND_GAP 128   // Pixels along the racing line before AI changes pace
 
 // Waypoint structure
 typedef struct {
@@ -20,26 +20,22 @@ typedef struct {
     int16_t y;
 } Waypoint;
 
-// AI car state
-typedef struct {
-    Car car;                    // Physics (position, velocity, angle)
-    uint8_t current_waypoint;   // Current target waypoint index
-    int8_t offset_x;           // Random offset from waypoint
-    int8_t offset_y;           // Random offset from waypoint
-    uint8_t sprite_index;      // Which sprite config (1-3)
-    uint8_t stuck_timer;       // Frames spent stuck (for detection)
-    uint8_t recovery_timer;    // Frames left in recovery mode
-    int8_t recovery_turn_dir;  // Turn direction during recovery: +1 or -1
-    int16_t last_recorded_x;   // Position 30 frames ago (for stuck detection)
-    int16_t last_recorded_y;
-    uint8_t rebound_timer;
-    uint8_t target_angle;      // Stored decision
-    uint8_t base_speed_shift;   // Stored decision
-    uint8_t last_thrust_shift; // Stored decision
-} AICar;
+// AI state, indexed by car slot (FIRST_AI_SLOT..NUM_CARS-1; see cars.h)
+extern int8_t ai_offset_x[NUM_CARS];          // Random offset from waypoint
+extern int8_t ai_offset_y[NUM_CARS];
+extern uint8_t ai_stuck_timer[NUM_CARS];      // Frames since the last stuck check
+extern int16_t ai_last_x[NUM_CARS];           // Position at the last stuck check
+extern int16_t ai_last_y[NUM_CARS];
+extern uint8_t ai_target_angle[NUM_CARS];     // Stored decision
+extern uint8_t ai_base_speed_shift[NUM_CARS]; // Stored decision
+extern uint8_t ai_thrust_shift[NUM_CARS];     // Stored decision
+extern uint8_t ai_think_age[NUM_CARS];        // Frames since the brain last ran
+
+// Brain steps since init_ai(), and how many ran with no frame time to spare
+extern uint16_t ai_brains_run;
+extern uint16_t ai_brains_forced;
 
 // External declarations
-extern AICar ai_cars[NUM_AI_CARS];
 extern Waypoint waypoints[NUM_WAYPOINTS];
 
 // Functions
@@ -47,6 +43,6 @@ void init_ai(void);
 void update_ai(void);
 void draw_ai_cars(int16_t scroll_x, int16_t scroll_y);
 extern uint8_t atan2_8(int16_t dy, int16_t dx);
-extern void update_ai_rubberbanding(AICar *ai);
+extern void update_ai_rubberbanding(uint8_t slot);
 
 #endif // AI_H
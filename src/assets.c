@@ -0,0 +1,79 @@
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "assets.h"
+#include "log.h"
+
+typedef struct {
+    uint16_t name_hash;
+    uint16_t size;
+    uint32_t content_hash;
+} ManifestEntry;
+
+static ManifestEntry manifest[MAX_MANIFEST_ENTRIES];
+static uint8_t manifest_count = 0;
+
+uint32_t asset_bytes_avoided = 0;
+
+void asset_manifest_load(void) {
+    manifest_count = 0;
+
+    int fd = open(ASSET_MANIFEST_FILE, O_RDONLY);
+    if (fd < 0) {
+        log_event(LOG_MANIFEST_ERROR, 0, 0, 0);
+        return;
+    }
+
+    // 1. Read header (1 byte): entry count
+    uint8_t file_count = 0;
+    read(fd, &file_count, 1);
+    if (file_count > MAX_MANIFEST_ENTRIES) file_count = MAX_MANIFEST_ENTRIES;
+
+    // 2. Read the entries directly into the array
+    int bytes = read(fd, manifest, file_count * sizeof(ManifestEntry));
+    if (bytes > 0) manifest_count = bytes / sizeof(ManifestEntry);
+
+    close(fd);
+    log_event(LOG_MANIFEST_LOADED, manifest_count, 0, 0);
+}
+
+// Must match name_hash() in make_asset_manifest.py
+uint16_t asset_name_hash(const char* name) {
+    uint16_t h = 5381;
+    while (*name) {
+        h = ((h << 5) + h) ^ (uint8_t)*name++;
+    }
+    return h;
+}
+
+static const ManifestEntry* find_entry(const char* filename) {
+    uint16_t nh = asset_name_hash(filename);
+    for (uint8_t i = 0; i < manifest_count; i++) {
+        if (manifest[i].name_hash == nh) return &manifest[i];
+    }
+    return NULL;
+}
+
+uint32_t asset_hash(const char* filename) {
+    const ManifestEntry* e = find_entry(filename);
+    return e ? e->content_hash : ASSET_HASH_NONE;
+}
+
+uint16_t asset_size(const char* filename) {
+    const ManifestEntry* e = find_entry(filename);
+    return e ? e->size : 0;
+}
+
+bool asset_is_resident(const char* filename, uint32_t* resident_hash) {
+    const ManifestEntry* e = find_entry(filename);
+    if (e && e->content_hash == *resident_hash) {
+        asset_bytes_avoided += e->size;
+        log_event(LOG_ASSET_SKIPPED, asset_name_hash(filename), e->size, 0);
+        return true;
+    }
+    return false;
+}
+
+void asset_loaded(const char* filename, uint32_t* resident_hash, bool ok) {
+    *resident_hash = ok ? asset_hash(filename) : ASSET_HASH_NONE;
+}
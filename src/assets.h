@@ -0,0 +1,31 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Content hashes for ROM assets, generated at build time into
+// ROM:manifest.bin (see tools/make_asset_manifest.py). Loaders compare
+// them with what's already resident to skip identical uploads.
+
+#define ASSET_MANIFEST_FILE   "ROM:manifest.bin"
+#define MAX_MANIFEST_ENTRIES  40  // Must match MAX_ENTRIES in make_asset_manifest.py
+#define ASSET_HASH_NONE       0   // Not in the manifest: always load
+
+extern uint32_t asset_bytes_avoided; // Running total of uploads skipped
+
+extern void asset_manifest_load(void);
+extern uint32_t asset_hash(const char* filename);
+extern uint16_t asset_name_hash(const char* name); // Also how log.h names assets
+extern uint16_t asset_size(const char* filename);
+
+// True if *resident_hash already matches filename's content (upload can be
+// skipped, counted in asset_bytes_avoided). Otherwise the caller loads it
+// and reports back with asset_loaded().
+extern bool asset_is_resident(const char* filename, uint32_t* resident_hash);
+
+// Record filename's content in *resident_hash after a successful load, or
+// forget it after a failed one so the next asset_is_resident() retries
+extern void asset_loaded(const char* filename, uint32_t* resident_hash, bool ok);
+
+#endif // ASSETS_H
@@ -0,0 +1,57 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio.h"
+#include "sound.h"
+#include "opl.h"
+#include "sched.h"
+
+#define QUEUE_MASK (SOUND_QUEUE_SIZE - 1)
+
+typedef struct {
+    uint8_t type;
+    uint16_t param;
+} SoundEvent;
+
+// Single producer (main loop) / single consumer (IRQ). Each index has one
+// writer and 8-bit stores are atomic on the 6502, so no locking is needed.
+static volatile SoundEvent queue[SOUND_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0; // Written only by sound_post()
+static volatile uint8_t queue_tail = 0; // Written only by the IRQ
+
+uint8_t sound_events_dropped = 0;
+
+bool sound_post(uint8_t type, uint16_t param) {
+    uint8_t head = queue_head;
+    uint8_t next = (head + 1) & QUEUE_MASK;
+    if (next == queue_tail) {
+        sound_events_dropped++;
+        return false;
+    }
+
+    queue[head].type = type;
+    queue[head].param = param;
+    queue_head = next; // Publish only after the slot is filled
+    return true;
+}
+
+// The ROM points the IRQ vector here (rp6502_executable IRQ in CMakeLists.txt)
+__attribute__((interrupt)) void audio_irq(void) {
+    RIA.irq = 1; // Acknowledge vsync (and keep it enabled)
+    sched_frame_start();
+
+    uint8_t tail = queue_tail;
+    while (tail != queue_head) {
+        sound_apply(queue[tail].type, queue[tail].param);
+        tail = (tail + 1) & QUEUE_MASK;
+    }
+    queue_tail = tail;
+
+    sound_tick();
+    update_music();
+}
+
+void audio_start(void) {
+    RIA.irq = 1; // Vsync interrupts on
+    __asm__ volatile("cli");
+}
@@ -0,0 +1,40 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Vsync-driven audio.
+//
+// Once audio_start() has run, music and sound effects tick from the vsync
+// IRQ, so a slow frame (track load, printf) no longer makes music drift.
+// Game code never touches the OPL itself: it posts events into a
+// single-producer/single-consumer ring that the IRQ drains every frame.
+// Every opl_write() after audio_start() happens inside the IRQ.
+
+typedef enum {
+    SND_ENGINE,      // param: velocity magnitude
+    SND_ENGINE_STOP,
+    // One-shot PSG effects (see psg.h)
+    SND_CRASH,
+    SND_DRS,
+    SND_LAP,
+    SND_SCREECH,
+    SND_WALL,
+    SND_BOOST,
+    SND_BEEP,
+    SND_GO,
+} SoundEventType;
+
+#define SOUND_QUEUE_SIZE 16 // Power of two; a frame posts at most a few
+
+extern uint8_t sound_events_dropped; // Posts lost to a full queue
+
+// Main loop only. Returns false (and drops the event) if the queue is full.
+extern bool sound_post(uint8_t type, uint16_t param);
+
+// Enable vsync interrupts. The ROM loads audio_irq into the IRQ vector.
+// All OPL setup (opl_init, patches, music_init) must be done before this.
+extern void audio_start(void);
+
+#endif // AUDIO_H
@@ -0,0 +1,35 @@
+#include <stdint.h>
+#include "cars.h"
+
+CAR_ZP uint8_t car_x_lo[NUM_CARS];
+CAR_ZP uint8_t car_x_hi[NUM_CARS];
+CAR_ZP uint8_t car_y_lo[NUM_CARS];
+CAR_ZP uint8_t car_y_hi[NUM_CARS];
+CAR_ZP uint8_t car_vx_lo[NUM_CARS];
+CAR_ZP uint8_t car_vx_hi[NUM_CARS];
+CAR_ZP uint8_t car_vy_lo[NUM_CARS];
+CAR_ZP uint8_t car_vy_hi[NUM_CARS];
+CAR_ZP uint8_t car_angle[NUM_CARS];
+CAR_ZP uint8_t car_rebound[NUM_CARS];
+
+uint8_t car_laps[NUM_CARS];
+uint8_t car_next_checkpoint[NUM_CARS];
+int8_t car_gate_side[NUM_CARS];
+uint8_t car_waypoint[NUM_CARS];
+uint16_t car_lap_progress[NUM_CARS];
+int16_t car_race_progress[NUM_CARS];
+
+// Place a car on the grid (pixels) at rest, looking for CP1
+void reset_car(uint8_t slot, int16_t px, int16_t py, uint8_t angle) {
+    CAR_SET16(car_x, slot, (uint16_t)px << 6);
+    CAR_SET16(car_y, slot, (uint16_t)py << 6);
+    CAR_SET16(car_vx, slot, 0);
+    CAR_SET16(car_vy, slot, 0);
+    car_angle[slot] = angle;
+    car_rebound[slot] = 0;
+
+    car_laps[slot] = 0;
+    car_next_checkpoint[slot] = 1;
+    car_gate_side[slot] = 0;
+    car_waypoint[slot] = 1; // Looking for the first corner
+}
@@ -0,0 +1,60 @@
+#ifndef CARS_H
+#define CARS_H
+
+#include <stdint.h>
+
+// Car state as parallel arrays indexed by car slot.
+// Slot 0 is the player, slots 1..NUM_AI_CARS are AI.
+// Indexed arrays let the 6502 reach any field with one abs,X / zp,X load
+// instead of 16-bit pointer arithmetic into a struct.
+
+#ifndef NUM_AI_CARS
+#define NUM_AI_CARS   3
+#endif
+#define NUM_CARS      (NUM_AI_CARS + 1)
+#define PLAYER_SLOT   0
+#define FIRST_AI_SLOT 1
+
+// Hottest per-frame fields live in zero page on the 65C02
+#ifdef __mos__
+#define CAR_ZP __zp
+#else
+#define CAR_ZP
+#endif
+
+// 16-bit fields are split into _lo/_hi byte arrays
+#define CAR_GET16(field, slot) \
+    ((int16_t)((uint16_t)field##_lo[slot] | ((uint16_t)field##_hi[slot] << 8)))
+// Positions are unsigned: 10.6 covers 0..1023 px, so tracks up to 128 tiles
+#define CAR_POS(field, slot) \
+    ((uint16_t)(field##_lo[slot] | ((uint16_t)field##_hi[slot] << 8)))
+#define CAR_SET16(field, slot, value) \
+    do { \
+        uint16_t _v = (uint16_t)(value); \
+        field##_lo[slot] = (uint8_t)_v; \
+        field##_hi[slot] = (uint8_t)(_v >> 8); \
+    } while (0)
+
+// --- Physics (touched every frame) ---
+extern CAR_ZP uint8_t car_x_lo[NUM_CARS];   // Position X (10.6 Fixed Point)
+extern CAR_ZP uint8_t car_x_hi[NUM_CARS];
+extern CAR_ZP uint8_t car_y_lo[NUM_CARS];   // Position Y (10.6 Fixed Point)
+extern CAR_ZP uint8_t car_y_hi[NUM_CARS];
+extern CAR_ZP uint8_t car_vx_lo[NUM_CARS];  // Velocity X (8.8 Fixed Point)
+extern CAR_ZP uint8_t car_vx_hi[NUM_CARS];
+extern CAR_ZP uint8_t car_vy_lo[NUM_CARS];  // Velocity Y (8.8 Fixed Point)
+extern CAR_ZP uint8_t car_vy_hi[NUM_CARS];
+extern CAR_ZP uint8_t car_angle[NUM_CARS];  // 0-255 (0=Up/North)
+extern CAR_ZP uint8_t car_rebound[NUM_CARS]; // Frames of stun after a hit
+
+// --- Lap System ---
+extern uint8_t car_laps[NUM_CARS];            // Count of completed laps
+extern uint8_t car_next_checkpoint[NUM_CARS]; // Gate index: 0=Finish, 1=CP1, 2=CP2, 3=CP3
+extern int8_t car_gate_side[NUM_CARS];        // Side of next gate last frame: -1 before, +1 past, 0 away
+extern uint8_t car_waypoint[NUM_CARS];        // Current target waypoint index
+extern uint16_t car_lap_progress[NUM_CARS];   // Last progress field sample (0..track_lap_length)
+extern int16_t car_race_progress[NUM_CARS];   // Pixels driven along the racing line since the start
+
+extern void reset_car(uint8_t slot, int16_t px, int16_t py, uint8_t angle);
+
+#endif // CARS_H
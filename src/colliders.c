@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "colliders.h"
+
+Collider colliders[MAX_COLLIDERS];
+uint8_t num_colliders = 0;
+uint8_t collider_tile_bits[MAP_WINDOW_TILES * COLLIDER_ROW_BYTES];
+
+// Tile range a box covers, clipped to the map
+static bool box_tiles(const Collider *c, uint8_t *tx0, uint8_t *ty0, uint8_t *tx1, uint8_t *ty1) {
+    int16_t x0 = c->x >> 3;
+    int16_t y0 = c->y >> 3;
+    int16_t x1 = (c->x + c->w - 1) >> 3;
+    int16_t y1 = (c->y + c->h - 1) >> 3;
+    if (x1 < 0 || y1 < 0 || x0 >= track_w_tiles || y0 >= track_h_tiles) return false;
+
+    *tx0 = (x0 < 0) ? 0 : x0;
+    *ty0 = (y0 < 0) ? 0 : y0;
+    *tx1 = (x1 >= track_w_tiles) ? track_w_tiles - 1 : x1;
+    *ty1 = (y1 >= track_h_tiles) ? track_h_tiles - 1 : y1;
+    return true;
+}
+
+static void mark_tiles(const Collider *c, bool set) {
+    uint8_t tx0, ty0, tx1, ty1;
+    if (!box_tiles(c, &tx0, &ty0, &tx1, &ty1)) return;
+
+    for (uint8_t ty = ty0; ty <= ty1; ty++) {
+        for (uint8_t tx = tx0; tx <= tx1; tx++) {
+            if (set) COLLIDER_TILE_BYTE(tx, ty) |= 0x80 >> (tx & 7);
+            else COLLIDER_TILE_BYTE(tx, ty) &= ~(0x80 >> (tx & 7));
+        }
+    }
+}
+
+void colliders_clear(void) {
+    // Only the tiles last frame's boxes touched, not the whole bitmap
+    for (uint8_t i = 0; i < num_colliders; i++) mark_tiles(&colliders[i], false);
+    num_colliders = 0;
+}
+
+bool collider_add(int16_t x, int16_t y, uint8_t w, uint8_t h) {
+    if (num_colliders >= MAX_COLLIDERS || w == 0 || h == 0) return false;
+    Collider *c = &colliders[num_colliders++];
+    c->x = x;
+    c->y = y;
+    c->w = w;
+    c->h = h;
+    mark_tiles(c, true);
+    return true;
+}
+
+bool collider_hit(int16_t x, int16_t y) {
+    for (uint8_t i = 0; i < num_colliders; i++) {
+        const Collider *c = &colliders[i];
+        if ((uint16_t)(x - c->x) < c->w && (uint16_t)(y - c->y) < c->h) return true;
+    }
+    return false;
+}
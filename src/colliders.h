@@ -0,0 +1,38 @@
+#ifndef COLLIDERS_H
+#define COLLIDERS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "constants.h"
+#include "track.h"
+
+// Dynamic collider overlay: moving gates, swinging barriers, debris.
+//
+// Boxes are registered each frame with collider_add() after a
+// colliders_clear(). Every map tile a box touches gets its bit set in
+// collider_tile_bits, and get_terrain_at() only looks at the boxes when that
+// bit is set, so the static wall test is untouched on every other tile and
+// costs a single byte test when no colliders exist at all. The bitmap wraps
+// like the map window, so it covers large tracks in the same 512 bytes.
+
+#define MAX_COLLIDERS 8
+#define COLLIDER_ROW_BYTES (MAP_WINDOW_TILES / 8)
+#define COLLIDER_TILE_BYTE(tx, ty) \
+    collider_tile_bits[((ty) & MAP_WINDOW_MASK) * COLLIDER_ROW_BYTES + (((tx) & MAP_WINDOW_MASK) >> 3)]
+
+typedef struct {
+    int16_t x, y; // Top-left, world pixels
+    uint8_t w, h;
+} Collider;
+
+extern Collider colliders[MAX_COLLIDERS];
+extern uint8_t num_colliders;
+extern uint8_t collider_tile_bits[MAP_WINDOW_TILES * COLLIDER_ROW_BYTES];
+
+extern void colliders_clear(void);
+// Returns false if the table is full
+extern bool collider_add(int16_t x, int16_t y, uint8_t w, uint8_t h);
+// Slow path for tiles with their bit set
+extern bool collider_hit(int16_t x, int16_t y);
+
+#endif // COLLIDERS_H
@@ -4,6 +4,8 @@
 #include "player.h"
 #include "ai.h"
 #include "track.h"
+#include "audio.h"
+#include "particles.h"
 
 // Physics Tuning
 #define PLAYER_PUSH_FORCE 0x0C0 // 1.0 pixel (Player resists push)
@@ -15,11 +17,14 @@
 #define PLAYER_STUN       5
 #define AI_STUN           10
 
-void resolve_player_ai_collision(Car *p, AICar *ai) {
-    Car *c2 = &ai->car; // Short alias for the AI's physics car
+void resolve_player_ai_collision(uint8_t slot) {
+    uint16_t px = CAR_POS(car_x, PLAYER_SLOT);
+    uint16_t py = CAR_POS(car_y, PLAYER_SLOT);
+    uint16_t ax = CAR_POS(car_x, slot);
+    uint16_t ay = CAR_POS(car_y, slot);
 
-    int16_t dx = (c2->x >> 6) - (p->x >> 6);
-    int16_t dy = (c2->y >> 6) - (p->y >> 6);
+    int16_t dx = (int16_t)(ax >> 6) - (int16_t)(px >> 6);
+    int16_t dy = (int16_t)(ay >> 6) - (int16_t)(py >> 6);
     
     // Quick Manhattan exit
     if (abs(dx) > 14 || abs(dy) > 14) return; // Slightly larger detection radius for high speed
@@ -31,18 +36,20 @@ void resolve_player_ai_collision(Car *p, AICar *ai) {
         // --- 1. MOMENTUM SWAP (Weighted) ---
         // Player keeps 50% of their momentum + 50% of AI's
         // AI takes 100% of Player's momentum
-        int16_t p_vx = p->vel_x;
-        int16_t p_vy = p->vel_y;
+        int16_t p_vx = CAR_GET16(car_vx, PLAYER_SLOT);
+        int16_t p_vy = CAR_GET16(car_vy, PLAYER_SLOT);
+        int16_t a_vx = CAR_GET16(car_vx, slot);
+        int16_t a_vy = CAR_GET16(car_vy, slot);
         
-        p->vel_x = (p->vel_x >> 1) + (c2->vel_x >> 1);
-        p->vel_y = (p->vel_y >> 1) + (c2->vel_y >> 1);
+        CAR_SET16(car_vx, PLAYER_SLOT, (p_vx >> 1) + (a_vx >> 1));
+        CAR_SET16(car_vy, PLAYER_SLOT, (p_vy >> 1) + (a_vy >> 1));
         
-        c2->vel_x = p_vx; // AI gets slammed with full player force
-        c2->vel_y = p_vy;
+        CAR_SET16(car_vx, slot, p_vx); // AI gets slammed with full player force
+        CAR_SET16(car_vy, slot, p_vy);
 
         // --- 2. THE SPIN ---
-        p->angle += (rand() % (PLAYER_SPIN * 2)) - PLAYER_SPIN;
-        c2->angle += (rand() % (AI_SPIN * 2)) - AI_SPIN;
+        car_angle[PLAYER_SLOT] += (rand() % (PLAYER_SPIN * 2)) - PLAYER_SPIN;
+        car_angle[slot] += (rand() % (AI_SPIN * 2)) - AI_SPIN;
 
         // --- 3. PHYSICAL SEPARATION (Asymmetric) ---
         int16_t push_x = (dx > 0) ? -1 : 1;
@@ -52,9 +59,9 @@ void resolve_player_ai_collision(Car *p, AICar *ai) {
         int16_t p_push_x = push_x * PLAYER_PUSH_FORCE;
         int16_t p_push_y = push_y * PLAYER_PUSH_FORCE;
         
-        if (get_terrain_at(((p->x + p_push_x) >> 6) + 8, ((p->y + p_push_y) >> 6) + 8) != TERRAIN_WALL) {
-            p->x += p_push_x;
-            p->y += p_push_y;
+        if (get_terrain_at(((px + p_push_x) >> 6) + 8, ((py + p_push_y) >> 6) + 8) != TERRAIN_WALL) {
+            CAR_SET16(car_x, PLAYER_SLOT, px + p_push_x);
+            CAR_SET16(car_y, PLAYER_SLOT, py + p_push_y);
         }
 
         // AI gets shoved hard
@@ -62,29 +69,34 @@ void resolve_player_ai_collision(Car *p, AICar *ai) {
         int16_t ai_push_y = -(push_y * AI_PUSH_FORCE_HVY);
 
         // Check if the destination is safe using the full hitbox check (from player.h)
-        if (!is_colliding_fast(((c2->x + ai_push_x) >> 6), ((c2->y + ai_push_y) >> 6))) {
-            c2->x += ai_push_x;
-            c2->y += ai_push_y;
+        if (!is_colliding_fast(((ax + ai_push_x) >> 6), ((ay + ai_push_y) >> 6))) {
+            CAR_SET16(car_x, slot, ax + ai_push_x);
+            CAR_SET16(car_y, slot, ay + ai_push_y);
         }
 
         // --- 4. TRIGGER STUN ---
-        extern uint8_t rebound_timer; // From player.c
-        rebound_timer = PLAYER_STUN;
-        ai->rebound_timer = AI_STUN;
+        car_rebound[PLAYER_SLOT] = PLAYER_STUN;
+        car_rebound[slot] = AI_STUN;
         
-        // Audio Feedack (Optional)
-        // play_crash_sound();
+        // Audio and sparks at the point of contact
+        sound_post(SND_CRASH, slot);
+        particle_spawn(PART_SPARK, (((px >> 6) + (ax >> 6)) >> 1) + 8,
+                       (((py >> 6) + (ay >> 6)) >> 1) + 8, 4);
     }
 }
 
 // 1.0 pixel in 10.6 fixed point
 #define AI_PUSH_FORCE 0x040 
 
-void resolve_ai_ai_collision(AICar *a1, AICar *a2) {
+void resolve_ai_ai_collision(uint8_t a, uint8_t b) {
     // 1. Quick Manhattan Distance check
     // 10.6 world coordinates >> 6 for pixels
-    int16_t dx = (int16_t)(a2->car.x >> 6) - (int16_t)(a1->car.x >> 6);
-    int16_t dy = (int16_t)(a2->car.y >> 6) - (int16_t)(a1->car.y >> 6);
+    uint16_t ax = CAR_POS(car_x, a);
+    uint16_t ay = CAR_POS(car_y, a);
+    uint16_t bx = CAR_POS(car_x, b);
+    uint16_t by = CAR_POS(car_y, b);
+    int16_t dx = (int16_t)(bx >> 6) - (int16_t)(ax >> 6);
+    int16_t dy = (int16_t)(by >> 6) - (int16_t)(ay >> 6);
     
     // Check for 8x8 pixel overlap (half of a car)
     // Using abs() on 16-bit is very fast on 6502
@@ -95,25 +107,43 @@ void resolve_ai_ai_collision(AICar *a1, AICar *a2) {
         if (dx == 0 && dy == 0) dx = 1; 
 
         // Physically separate them
-        if (dx > 0) { a1->car.x -= AI_PUSH_FORCE; a2->car.x += AI_PUSH_FORCE; }
-        else       { a1->car.x += AI_PUSH_FORCE; a2->car.x -= AI_PUSH_FORCE; }
+        if (dx > 0) { ax -= AI_PUSH_FORCE; bx += AI_PUSH_FORCE; }
+        else       { ax += AI_PUSH_FORCE; bx -= AI_PUSH_FORCE; }
 
-        if (dy > 0) { a1->car.y -= AI_PUSH_FORCE; a2->car.y += AI_PUSH_FORCE; }
-        else       { a1->car.y += AI_PUSH_FORCE; a2->car.y -= AI_PUSH_FORCE; }
+        if (dy > 0) { ay -= AI_PUSH_FORCE; by += AI_PUSH_FORCE; }
+        else       { ay += AI_PUSH_FORCE; by -= AI_PUSH_FORCE; }
 
-        // 3. MOMENTUM SWAP (Fastest way)
-        int16_t tvx = a1->car.vel_x;
-        a1->car.vel_x = a2->car.vel_x;
-        a2->car.vel_x = tvx;
+        CAR_SET16(car_x, a, ax); CAR_SET16(car_y, a, ay);
+        CAR_SET16(car_x, b, bx); CAR_SET16(car_y, b, by);
 
-        int16_t tvy = a1->car.vel_y;
-        a1->car.vel_y = a2->car.vel_y;
-        a2->car.vel_y = tvy;
+        // 3. MOMENTUM SWAP (Fastest way: swap the bytes)
+        uint8_t t;
+        t = car_vx_lo[a]; car_vx_lo[a] = car_vx_lo[b]; car_vx_lo[b] = t;
+        t = car_vx_hi[a]; car_vx_hi[a] = car_vx_hi[b]; car_vx_hi[b] = t;
+        t = car_vy_lo[a]; car_vy_lo[a] = car_vy_lo[b]; car_vy_lo[b] = t;
+        t = car_vy_hi[a]; car_vy_hi[a] = car_vy_hi[b]; car_vy_hi[b] = t;
 
         // 4. JITTER
         // Instead of rand(), use the VSync LSB to tweak angles
         // This stops them from locking together in a perfectly straight line
-        a1->car.angle += (RIA.vsync & 0x03);
-        a2->car.angle -= (RIA.vsync & 0x03);
+        car_angle[a] += (RIA.vsync & 0x03);
+        car_angle[b] -= (RIA.vsync & 0x03);
     }
-}
\ No newline at end of file
+}
+
+void resolve_all_collisions(void) {
+    // A. FULL PHYSICS: Player vs every AI
+    // Keep your heavy resolve_car_collision function for these
+    // It should include the wall-checks and sound effects
+    for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+        resolve_player_ai_collision(i); 
+    }
+
+    // B. LIGHT REPULSION: AI vs each other (every pair)
+    // Use the new optimized function that skips wall lookups
+    for (uint8_t a = FIRST_AI_SLOT; a < NUM_CARS - 1; a++) {
+        for (uint8_t b = a + 1; b < NUM_CARS; b++) {
+            resolve_ai_ai_collision(a, b);
+        }
+    }
+}
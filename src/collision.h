@@ -2,8 +2,10 @@
 #define COLLISION_H
 
 #include "player.h"
-extern void resolve_player_ai_collision(Car *p, AICar *ai);
-extern void resolve_ai_ai_collision(AICar *a1, AICar *a2);
+#include "ai.h"
+extern void resolve_player_ai_collision(uint8_t slot);
+extern void resolve_ai_ai_collision(uint8_t a, uint8_t b);
+extern void resolve_all_collisions(void);
 
 
 #endif // COLLISION_H
\ No newline at end of file
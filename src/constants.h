@@ -13,21 +13,30 @@
 #define SPRITE_DATA_END         (SPRITE_DATA_START + REDRACER_DATA_SIZE)
 
 // XRAM memory layout:
-// 0x0000-0x0800: Car sprite data (4 cars × 512 bytes each)
-// 0x0800-0x0850: Configuration structs (player + 3 AI cars)
-// 0x0850-0x1450: Tile map (3072 bytes)
-// 0x1450-0x3370: Tile graphics
-
-// Tile data configuration
-#define TRACK_MAP_ADDR          0x0850U // Address for track map data in XRAM
-#define TRACK_DATA              0x1450U // Address for track tile data in XRAM (Re-used for tiles.bin)
-#define TRACK_DATA_SIZE         0x2000U // Size of track tile data (8192 bytes = 256 tiles * 32 bytes)
-#define TRACK_DATA_END          (TRACK_DATA + TRACK_DATA_SIZE)
+// 0x0000-0x0800: Car sprite data (4 cars x 512 bytes each, placed by the ROM loader)
+// 0x0800-0x16D7: Boot image (plane and sprite configs, text RAM; ROM loader)
+// 0x16D7-0xFE00: Allocated at runtime by xram.c (title, particles, tiles, maps)
+// 0xFE00-0xFFFF: Device registers below
+
+// Boot image, built by tools/make_boot_image.py (offsets must match it).
+// CMake passes the address to both.
+#ifndef BOOT_IMAGE_ADDR
+#define BOOT_IMAGE_ADDR         (SPRITE_DATA_END)
+#endif
+#if BOOT_IMAGE_ADDR < SPRITE_DATA_END
+#error "BOOT_IMAGE_ADDR overlaps the car sprites"
+#endif
+#define BOOT_IMAGE_VERSION      1
+#define BOOT_MAX_CARS           8
+#define BOOT_TAG_ADDR           (BOOT_IMAGE_ADDR)          // 'R', 'M', version, car count
+#define BOOT_TRACK_CONFIG       (BOOT_IMAGE_ADDR + 0x0004) // vga_mode2_config_t
+#define BOOT_TEXT_CONFIG        (BOOT_IMAGE_ADDR + 0x0014) // vga_mode1_config_t
+#define BOOT_SPRITE_CONFIGS     (BOOT_IMAGE_ADDR + 0x0024) // vga_mode4_asprite_t x BOOT_MAX_CARS
+#define BOOT_TEXT_RAM           (BOOT_IMAGE_ADDR + 0x00C4) // MESSAGE_LENGTH chars, 3 bytes each
+#define BOOT_IMAGE_END          (BOOT_IMAGE_ADDR + 0x0ED7)
 
-#define TITLE_MAP_ADDR          0x4284U // Address for title map data in XRAM (Aligned)
-#define TITLE_DATA              0x4E84U // Address for title tile data in XRAM (Aligned)
+#define TRACK_DATA_SIZE         0x2000U // Size of track tile data (8192 bytes = 256 tiles * 32 bytes)
 #define TITLE_DATA_SIZE         0x2000U // Size of title tile data (8192 bytes = 256 tiles * 32 bytes)
-#define TITLE_DATA_END          (TITLE_DATA + TITLE_DATA_SIZE)
 
 // 5. Keyboard, Gamepad and Sound
 // -------------------------------------------------------------------------
@@ -35,13 +44,12 @@
 #define PALETTE_ADDR    0xFF58  // XRAM address for palette data
 #define GAMEPAD_INPUT   0xFF78  // XRAM address for gamepad data
 #define KEYBOARD_INPUT  0xFFA0  // XRAM address for keyboard data
-#define PSG_XRAM_ADDR   0xFFC0  // PSG memory location (must match sound.c)
+#define PSG_XRAM_ADDR   0xFFC0  // PSG channels (8 x 8 bytes, see psg.c)
 
 extern unsigned REDRACER_CONFIG;  // RedRacer Sprite Configuration
 extern unsigned TRACK_CONFIG;     // Track Tilemap Configuration
 extern unsigned TEXT_CONFIG;      // Text Overlay Configuration
 extern unsigned text_message_addr; // Start address for text messages in XRAM
-extern unsigned TITLE_MAP_START;  // Start address for title map data in XRAM
 
 // Track tile map
 #define TRACK_MAP_WIDTH_TILES   64
@@ -7,9 +7,11 @@
 #include "input.h"
 #include "racelogic.h"
 #include "player.h"
+#include "layer2.h"
 #include "racelogic.h"
 #include "player.h"
 #include "track.h"
+#include "pacing.h"
 char message[MESSAGE_LENGTH + 1]; // +1 for null terminator
 
 void hud_print(uint8_t x, uint8_t y, const char* str, uint8_t fg, uint8_t bg) {
@@ -30,7 +32,7 @@ void hud_print(uint8_t x, uint8_t y, const char* str, uint8_t fg, uint8_t bg) {
     }
 }
 
-void hud_refresh_stats(uint8_t lap, uint16_t speed) {
+void hud_refresh_stats(uint8_t lap, uint16_t speed, uint8_t position) {
     char buf[10];
     
     // 1. Update Lap Display (Top Left)
@@ -42,6 +44,11 @@ void hud_refresh_stats(uint8_t lap, uint16_t speed) {
     // Logic: speed is 8.8, so high byte is roughly MPH
     sprintf(buf, "%3d MPH", speed >> 2);
     hud_print(HUD_COL_TIME, HUD_ROW, buf, 11, HUD_COL_BG); // Light Blue for speed
+
+    // 3. Update Position Display (Below speed)
+    // POS: 1/4
+    sprintf(buf, "POS:%d/%d", position, NUM_CARS);
+    hud_print(HUD_COL_POS, HUD_ROW + 1, buf, HUD_COL_WHITE, HUD_COL_BG);
 }
 
 void update_countdown_display(uint16_t delay) {
@@ -77,18 +84,14 @@ void update_title_screen(void) {
     uint8_t color = rainbow_table[(RIA.vsync >> 2) % 30];
     hud_print(10, 18, " PRESS FIRE TO START ", color, 0);
     
-    if (is_action_pressed(0, ACTION_FIRE)) {
+    if (is_action_just_pressed(0, ACTION_FIRE)) {
         // Clear title text
         hud_print(10, 18, "                     ", 0, 0);
         current_state = STATE_COUNTDOWN;
         state_timer = COUNTDOWN_TOTAL_TIME; 
 
-        RIA.addr0 = TITLE_MAP_START;
-        RIA.step0 = 1;
-        // Remove title screen
-        for (int i = 0; i < TITLE_NUMBER_OF_TILES; i++) {
-            RIA.rw0 = 0;
-        }
+        // Remove title screen (switch plane 2 away; the map itself is untouched)
+        hide_title_plane();
 
     }
 }
@@ -114,6 +117,9 @@ void update_finished_screen(void) {
         hud_print(9, 16, " BETTER LUCK NEXT TIME ", HUD_COL_GREY, HUD_COL_BG);
     }
 
+    // Frame pacing for the race just run (see pacing.h)
+    hud_print((MESSAGE_WIDTH - strlen(pacing_summary)) / 2, 21, pacing_summary, HUD_COL_GREY, HUD_COL_BG);
+
     if (state_timer > 0) {
         state_timer--;
     } else {
@@ -124,7 +130,7 @@ void update_finished_screen(void) {
             hud_print(10, 18, "                      ", 0, 0);
         }
 
-        if (is_action_pressed(0, ACTION_PAUSE)) { 
+        if (is_action_just_pressed(0, ACTION_PAUSE)) { 
             if (race_winner == 0) {
                 // Player won: advance to next track and go straight into race
                 current_track_id++;
@@ -12,25 +12,19 @@
 // Button mapping storage
 ButtonMapping button_mappings[GAMEPAD_COUNT][ACTION_COUNT];
 
-// Gamepad state structure
-gamepad_t gamepad[GAMEPAD_COUNT];
+// Action bitmasks, rebuilt every frame by handle_input()
+uint16_t action_held[GAMEPAD_COUNT];
+uint16_t action_pressed[GAMEPAD_COUNT];
+uint16_t action_released[GAMEPAD_COUNT];
 
-// Keyboard state (defined in definitions.h, but declared here)
-uint8_t keystates[KEYBOARD_BYTES] = {0};
-bool handled_key = false;
+// Keyboard lookup resolved from button_mappings[0] at init:
+// XRAM byte offset and bit mask of each action's key
+static uint8_t key_offset[ACTION_COUNT];
+static uint8_t key_mask[ACTION_COUNT];
 
 // Helper for checking if any input is pressed (mainly for demo mode)
 bool is_any_input_pressed(void) {
-    // Check all relevant bits
-    if (is_action_pressed(0, ACTION_THRUST)) return true;
-    if (is_action_pressed(0, ACTION_REVERSE_THRUST)) return true;
-    if (is_action_pressed(0, ACTION_ROTATE_LEFT)) return true;
-    if (is_action_pressed(0, ACTION_ROTATE_RIGHT)) return true;
-    if (is_action_pressed(0, ACTION_FIRE)) return true;
-    if (is_action_pressed(0, ACTION_SUPER_FIRE)) return true;
-    if (is_action_pressed(0, ACTION_PAUSE)) return true;
-    if (is_action_pressed(0, ACTION_RESCUE)) return true;
-    return false;
+    return action_held[0] != 0;
 }
 
 /**
@@ -142,6 +136,18 @@ bool load_joystick_config(void)
     return true;
 }
 
+/**
+ * Cache which keyboard byte/bit each action reads (keyboard is player 0 only)
+ */
+static void resolve_key_lookup(void)
+{
+    for (uint8_t a = 0; a < ACTION_COUNT; a++) {
+        uint8_t code = button_mappings[0][a].keyboard_key;
+        key_offset[a] = code >> 3;
+        key_mask[a] = 1 << (code & 7);
+    }
+}
+
 /**
  * Initialize input system with default button mappings
  */
@@ -154,36 +160,56 @@ void init_input_system(void)
             reset_button_mappings(player);
         }
     }
+    resolve_key_lookup();
+
+    for (uint8_t player = 0; player < GAMEPAD_COUNT; player++) {
+        action_held[player] = 0;
+        action_pressed[player] = 0;
+        action_released[player] = 0;
+    }
 }
 
 /**
- * Read keyboard and gamepad input
+ * Read keyboard and gamepad input and resolve every action once.
+ * Only the mapped key bytes and the digital bytes of connected pads are read.
  */
 void handle_input(void)
 {
-    // Read all keyboard state bytes
-    RIA.addr0 = KEYBOARD_INPUT;
-    RIA.step0 = 1;
-    for (uint8_t i = 0; i < KEYBOARD_BYTES; i++) {
-        keystates[i] = RIA.rw0;
-    }
-    
-    // Read gamepad data
-    RIA.addr0 = GAMEPAD_INPUT;
-    RIA.step0 = 1;
-    for (uint8_t i = 0; i < GAMEPAD_COUNT; i++) {
-        gamepad[i].dpad = RIA.rw0;
-        gamepad[i].sticks = RIA.rw0;
-        gamepad[i].btn0 = RIA.rw0;
-        gamepad[i].btn1 = RIA.rw0;
-        gamepad[i].lx = RIA.rw0;
-        gamepad[i].ly = RIA.rw0;
-        gamepad[i].rx = RIA.rw0;
-        gamepad[i].ry = RIA.rw0;
-        gamepad[i].l2 = RIA.rw0;
-        gamepad[i].r2 = RIA.rw0;
+    for (uint8_t player = 0; player < GAMEPAD_COUNT; player++) {
+        uint16_t held = 0;
+
+        // Keyboard (player 0 only for now)
+        if (player == 0) {
+            for (uint8_t a = 0; a < ACTION_COUNT; a++) {
+                RIA.addr0 = KEYBOARD_INPUT + key_offset[a];
+                if (RIA.rw0 & key_mask[a]) held |= ACTION_BIT(a);
+            }
+        }
+
+        // Gamepad: dpad byte carries the connected flag, skip the rest if absent
+        uint8_t fields[4]; // dpad, sticks, btn0, btn1 (GP_FIELD_*)
+        RIA.addr0 = GAMEPAD_INPUT + player * sizeof(gamepad_t);
+        RIA.step0 = 1;
+        fields[GP_FIELD_DPAD] = RIA.rw0;
+
+        if (fields[GP_FIELD_DPAD] & GP_CONNECTED) {
+            fields[GP_FIELD_STICKS] = RIA.rw0;
+            fields[GP_FIELD_BTN0] = RIA.rw0;
+            fields[GP_FIELD_BTN1] = RIA.rw0;
+
+            ButtonMapping* mapping = button_mappings[player];
+            for (uint8_t a = 0; a < ACTION_COUNT; a++) {
+                if (fields[mapping[a].gamepad_button & 3] & mapping[a].gamepad_mask) {
+                    held |= ACTION_BIT(a);
+                }
+            }
+        }
+
+        // Edges against last frame
+        action_pressed[player] = held & ~action_held[player];
+        action_released[player] = action_held[player] & ~held;
+        action_held[player] = held;
     }
-    
 }
 
 /**
@@ -195,28 +221,5 @@ bool is_action_pressed(uint8_t player_id, GameAction action)
         return false;
     }
     
-    ButtonMapping* mapping = &button_mappings[player_id][action];
-    
-    // Check keyboard (player 0 only for now)
-    if (player_id == 0) {
-        if (key(mapping->keyboard_key)) {
-            return true;
-        }
-    }
-    
-    // Only check gamepad if one is connected
-    if (!(gamepad[player_id].dpad & GP_CONNECTED)) {
-        return false;
-    }
-    
-    // Check gamepad
-    uint8_t gamepad_value = 0;
-    switch (mapping->gamepad_button) {
-        case 0: gamepad_value = gamepad[player_id].dpad; break;
-        case 1: gamepad_value = gamepad[player_id].sticks; break;
-        case 2: gamepad_value = gamepad[player_id].btn0; break;
-        case 3: gamepad_value = gamepad[player_id].btn1; break;
-    }
-    
-    return (gamepad_value & mapping->gamepad_mask) != 0;
-}
\ No newline at end of file
+    return is_action_down(player_id, action);
+}
@@ -50,13 +50,6 @@
 // BUTTON MAPPING SYSTEM
 // ============================================================================
 
-// Keyboard state array and macro
-extern uint8_t keystates[KEYBOARD_BYTES];
-extern bool handled_key;
-
-// Macro to check if a key is pressed
-#define key(code) (keystates[code >> 3] & (1 << (code & 7)))
-
 // Game actions that can be mapped
 typedef enum {
     ACTION_THRUST,
@@ -98,6 +91,18 @@ typedef struct {
 #define GP_FIELD_BTN0    2  // Face Buttons (A,B,X,Y)
 #define GP_FIELD_BTN1    3  // Triggers/Select/Start
 
+// Per-frame action bitmasks (bit n = GameAction n), resolved once by handle_input()
+extern uint16_t action_held[GAMEPAD_COUNT];     // Down this frame
+extern uint16_t action_pressed[GAMEPAD_COUNT];  // Went down this frame (edge)
+extern uint16_t action_released[GAMEPAD_COUNT]; // Went up this frame (edge)
+
+#define ACTION_BIT(action) ((uint16_t)1 << (action))
+
+// Single AND tests for game code (player_id must be < GAMEPAD_COUNT)
+#define is_action_down(player_id, action)     ((action_held[player_id] & ACTION_BIT(action)) != 0)
+#define is_action_just_pressed(player_id, action)  ((action_pressed[player_id] & ACTION_BIT(action)) != 0)
+#define is_action_released(player_id, action) ((action_released[player_id] & ACTION_BIT(action)) != 0)
+
 extern void init_input_system(void);
 extern void handle_input(void);
 extern bool is_action_pressed(uint8_t player_id, GameAction action);
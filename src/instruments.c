@@ -2,6 +2,7 @@
 #include <rp6502.h>
 #include <stdint.h>
 #include "instruments.h"
+#include "voices.h"
 
 // Auto-generated Standard Bank (AdLib Compatible)
 const OPL_Patch gm_bank[128] = {
@@ -141,25 +142,23 @@ const OPL_Patch drum_hihat = { .m_ave=0x05, .m_ksl=0x00, .m_atdec=0xF0, .m_susre
 
 // Ensure the Patch Setup hits the correct OPL2 operators
 void OPL_SetPatch(uint8_t channel, const OPL_Patch* p) {
-    static const uint8_t mod_offsets[] = {0x00,0x01,0x02,0x08,0x09,0x0A,0x10,0x11,0x12};
-    static const uint8_t car_offsets[] = {0x03,0x04,0x05,0x0B,0x0C,0x0D,0x13,0x14,0x15};
-    
-    uint8_t m = mod_offsets[channel];
-    uint8_t c = car_offsets[channel];
+    uint8_t m = opl_mod_offsets[channel];
+    uint8_t c = opl_car_offsets[channel];
 
     // Save KSL for volume calculations
-    // shadow_ksl_c[channel] = p->c_ksl;
-    const uint8_t* p_bytes = (const uint8_t*)p;
+    shadow_ksl_m[channel] = p->m_ksl;
+    shadow_ksl_c[channel] = p->c_ksl;
 
-    opl_write(0x20 + m, p->m_ave);
-    opl_write(0x20 + c, p->c_ave);
-    opl_write(0x40 + m, p->m_ksl);
-    opl_write(0x40 + c, p->c_ksl);
-    opl_write(0x60 + m, p->m_atdec);
-    opl_write(0x60 + c, p->c_atdec);
-    opl_write(0x80 + m, p->m_susrel);
-    opl_write(0x80 + c, p->c_susrel);
-    opl_write(0xE0 + m, p->m_wave);
-    opl_write(0xE0 + c, p->c_wave);
-    opl_write(0xC0 + channel, p->feedback);
+    // Music channel registers: the voice manager maps them to hardware
+    opl_music_write(0x20 + m, p->m_ave);
+    opl_music_write(0x20 + c, p->c_ave);
+    opl_music_write(0x40 + m, p->m_ksl);
+    opl_music_write(0x40 + c, p->c_ksl);
+    opl_music_write(0x60 + m, p->m_atdec);
+    opl_music_write(0x60 + c, p->c_atdec);
+    opl_music_write(0x80 + m, p->m_susrel);
+    opl_music_write(0x80 + c, p->c_susrel);
+    opl_music_write(0xE0 + m, p->m_wave);
+    opl_music_write(0xE0 + c, p->c_wave);
+    opl_music_write(0xC0 + channel, p->feedback);
 }
\ No newline at end of file
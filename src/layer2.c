@@ -1,33 +1,62 @@
 #include <rp6502.h>
-#include <stdio.h>
-#include <fcntl.h>
-#include <unistd.h>
 #include "layer2.h"
 #include "constants.h"
+#include "xram.h"
 
-void load_plane2(void)
+#define TITLE_PLANE 2
+
+unsigned TITLE_CONFIG;            // Title tilemap configuration
+static unsigned BLANK_CONFIG;     // 1x1 transparent tilemap shown when the title is hidden
+
+static uint16_t title_map_xram = XRAM_NULL;
+static uint16_t title_tiles_xram = XRAM_NULL;
+
+static void set_tilemap_config(unsigned config, bool wrap, int16_t w, int16_t h,
+                               uint16_t map, uint16_t tiles) {
+    xram0_struct_set(config, vga_mode2_config_t, x_wrap, wrap);
+    xram0_struct_set(config, vga_mode2_config_t, y_wrap, wrap);
+    xram0_struct_set(config, vga_mode2_config_t, x_pos_px, 0);
+    xram0_struct_set(config, vga_mode2_config_t, y_pos_px, 0);
+    xram0_struct_set(config, vga_mode2_config_t, width_tiles, w);
+    xram0_struct_set(config, vga_mode2_config_t, height_tiles, h);
+    xram0_struct_set(config, vga_mode2_config_t, xram_data_ptr, map);
+    xram0_struct_set(config, vga_mode2_config_t, xram_palette_ptr, PALETTE_ADDR);
+    xram0_struct_set(config, vga_mode2_config_t, xram_tile_ptr, tiles);
+}
+
+void init_plane2(void)
 {
-    // Load Title Map and Tiles dynamic from filesystem (assets/)
-    int fd;
-
-    // 1. Load Tile Data (Graphics)
-    fd = open("ROM:title_tiles.bin", O_RDONLY);
-    if (fd >= 0) {
-        // read_xram reads directly from file descriptor to XRAM address
-        read_xram(TITLE_DATA, TITLE_DATA_SIZE, fd);
-        close(fd);
-        printf("Loaded ROM:title_tiles.bin\n");
-    } else {
-        printf("Error: Could not open ROM:title_tiles.bin\n");
-    }
+    TITLE_CONFIG = xram_alloc("title config", sizeof(vga_mode2_config_t));
+    BLANK_CONFIG = xram_alloc("blank config", sizeof(vga_mode2_config_t));
 
-    // 2. Load Tile Map (Layout)
-    fd = open("ROM:title_map.bin", O_RDONLY);
-    if (fd >= 0) {
-        read_xram(TITLE_MAP_ADDR, TITLE_MAP_SIZE, fd);
-        close(fd);
-        printf("Loaded ROM:title_map.bin\n");
-    } else {
-        printf("Error: Could not open ROM:title_map.bin\n");
+    // One map byte (tile 0) + one all-zero 8x8 4bpp tile = nothing drawn
+    uint16_t blank_tile = xram_alloc("blank tile", 1 + 32);
+    RIA.addr0 = blank_tile;
+    RIA.step0 = 1;
+    for (uint8_t i = 0; i < 1 + 32; i++) {
+        RIA.rw0 = 0;
     }
+    set_tilemap_config(BLANK_CONFIG, false, 1, 1, blank_tile, blank_tile + 1);
+
+    hide_title_plane();
+}
+
+void show_title_plane(void)
+{
+    // Resident after the first time, so this is normally just two lookups
+    title_tiles_xram = xram_load("ROM:title_tiles.bin", TITLE_DATA_SIZE);
+    title_map_xram = xram_load("ROM:title_map.bin", TITLE_MAP_SIZE);
+    if (title_tiles_xram == XRAM_NULL || title_map_xram == XRAM_NULL) return;
+
+    set_tilemap_config(TITLE_CONFIG, true, TITLE_MAP_WIDTH_TILES, TITLE_MAP_HEIGHT_TILES,
+                       title_map_xram, title_tiles_xram);
+    xregn(1, 0, 1, 4, 2, 0x02, TITLE_CONFIG, TITLE_PLANE); // Titles on 2
+}
+
+void hide_title_plane(void)
+{
+    // Swap the plane to the blank map; title data stays resident (evictable)
+    xregn(1, 0, 1, 4, 2, 0x02, BLANK_CONFIG, TITLE_PLANE);
+    xram_release(title_tiles_xram);
+    xram_release(title_map_xram);
 }
@@ -3,6 +3,10 @@
 
 #include <stdint.h>
 
-void load_plane2(void);
+extern unsigned TITLE_CONFIG; // Title tilemap configuration
+
+void init_plane2(void);
+void show_title_plane(void);
+void hide_title_plane(void);
 
 #endif // LAYER2_H
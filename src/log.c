@@ -0,0 +1,64 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "log.h"
+
+#define RING_MASK (LOG_RING_SIZE - 1)
+
+typedef struct {
+    uint8_t id;
+    uint8_t vsync; // RIA.vsync when logged; the decoder shows it as is
+    uint16_t arg[3];
+} LogRecord;
+
+static LogRecord ring[LOG_RING_SIZE];
+static uint8_t ring_head = 0; // Next free slot
+static uint8_t ring_tail = 0; // Oldest pending record
+static int log_fd = -1;
+
+uint8_t log_dropped = 0;
+
+void log_init(void) {
+    ring_head = ring_tail = 0;
+    log_fd = open(LOG_FILE, O_WRONLY | O_CREAT | O_TRUNC);
+    if (log_fd < 0) return;
+
+    // Header: magic, version, record size
+    static const uint8_t header[6] = {'R', 'L', 'O', 'G', LOG_VERSION, sizeof(LogRecord)};
+    write(log_fd, header, sizeof(header));
+}
+
+void log_event(uint8_t id, uint16_t a, uint16_t b, uint16_t c) {
+    uint8_t head = ring_head;
+    uint8_t next = (head + 1) & RING_MASK;
+    if (next == ring_tail) {
+        if (log_dropped < 0xFF) log_dropped++;
+        return;
+    }
+
+    LogRecord *r = &ring[head];
+    r->id = id;
+    r->vsync = RIA.vsync;
+    r->arg[0] = a;
+    r->arg[1] = b;
+    r->arg[2] = c;
+    ring_head = next;
+}
+
+bool log_drain(void) {
+    uint8_t head = ring_head;
+    uint8_t tail = ring_tail;
+    if (head == tail) return false;
+
+    // Up to the head, or to the end of the array if the ring has wrapped
+    uint8_t end = (head > tail) ? head : LOG_RING_SIZE;
+    if (log_fd >= 0) write(log_fd, &ring[tail], (end - tail) * sizeof(LogRecord));
+    ring_tail = end & RING_MASK;
+    return ring_tail != head;
+}
+
+void log_flush(void) {
+    while (log_drain());
+}
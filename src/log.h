@@ -0,0 +1,77 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Deferred binary logging.
+//
+// log_event() stores an 8-byte record (event id, vsync stamp, three 16-bit
+// args) in a RAM ring: no formatting and no console I/O on the spot. An idle
+// task appends pending records to LOG_FILE on the USB drive, and log_flush()
+// writes out the rest on demand (after a track load, at the end of a race).
+// tools/decode_log.py turns the file back into text using the format
+// strings below, read straight from this header. Besides the usual %u, %d
+// and %X, %a prints an asset, XRAM block or task from its name hash
+// (asset_name_hash()), %C a car slot and %P a pacing stage (pacing.h).
+//
+// Main loop only; the audio IRQ never logs.
+
+#define LOG_FILE      "racelog.bin"
+#define LOG_RING_SIZE 32 // Records; power of two
+#define LOG_VERSION   1
+
+// X(id, "format"). Append only: ids are file format.
+#define LOG_EVENTS(X) \
+    X(LOG_LAP,              "%C completed lap %u") \
+    X(LOG_RESCUE,           "Rescued to WP %u") \
+    X(LOG_MUSIC_READ_ERROR, "Music: read error %d") \
+    X(LOG_MUSIC_OPEN_ERROR, "Music: failed to open %a") \
+    X(LOG_OPEN_ERROR,       "Error opening %a") \
+    X(LOG_READ_ERROR,       "Error reading %a") \
+    X(LOG_RAM_LOAD,         "Loaded %a to RAM (%u bytes)") \
+    X(LOG_XRAM_LOAD,        "Loaded %a to XRAM 0x%04X") \
+    X(LOG_XRAM_RESIDENT,    "%a resident at XRAM 0x%04X") \
+    X(LOG_XRAM_EVICT,       "XRAM: evicting %a (%u bytes)") \
+    X(LOG_ASSET_SKIPPED,    "%a unchanged, skipped %u bytes") \
+    X(LOG_CHUNKS_STREAMED,  "Streamed %u map chunks") \
+    X(LOG_WAYPOINTS,        "Loading waypoints: file has %u") \
+    X(LOG_WAYPOINTS_CUT,    "Warning: truncating waypoints to %u") \
+    X(LOG_PROGRESS_LOADED,  "Loaded %a (lap %u px)") \
+    X(LOG_GATES_LOADED,     "Loaded %a (%u gates)") \
+    X(LOG_TRACK_CACHED,     "Track %u already loaded, skipping") \
+    X(LOG_TRACK_LOADED,     "Track %u loaded, %u bytes already resident (%u total)") \
+    X(LOG_FRAME_DROP,       "Dropped %u frames in state %u, heaviest stage %P") \
+    X(LOG_TRACK_BANKS,      "Track %u has %u tile banks, built for %u") \
+    X(LOG_SCHED_FULL,       "Error: Task table full (%u), dropped a task costing %u") \
+    X(LOG_BOOT_MISMATCH,    "Error: boot image is version %u for %u cars, this build wants %u cars") \
+    X(LOG_MANIFEST_ERROR,   "Error opening the asset manifest") \
+    X(LOG_MANIFEST_LOADED,  "Loaded the asset manifest (%u assets)") \
+    X(LOG_XRAM_TABLE_FULL,  "Error: XRAM block table full, can't fit %a (%u bytes)") \
+    X(LOG_XRAM_FULL,        "Error: XRAM full, can't fit %a (%u bytes)") \
+    X(LOG_TRACE_ERROR,      "Error opening the trace file") \
+    X(LOG_TRACE_DUMPED,     "Trace: %u events written") \
+    X(LOG_TASK_STEPS,       "Task %a: %u steps, avg %u cycles") \
+    X(LOG_TASK_WORST,       "Task %a: worst %u cycles, declared %u") \
+    X(LOG_TASK_LATE,        "Task %a: %u forced, %u over cost") \
+    X(LOG_AI_BRAINS,        "AI brains: %u (%u forced)") \
+    X(LOG_TERRAIN_CACHE,    "Terrain cache: %u misses, %u row fills, %u chunks forced") \
+    X(LOG_RECORDS_DROPPED,  "Log: %u records dropped")
+
+#define LOG_ENUM(id, fmt) id,
+enum { LOG_EVENTS(LOG_ENUM) LOG_EVENT_COUNT };
+#undef LOG_ENUM
+
+extern uint8_t log_dropped; // Records lost to a full ring
+
+// Create LOG_FILE (header only). Without a drive, records are discarded.
+extern void log_init(void);
+
+// Drops the record (and counts it) if the ring is full
+extern void log_event(uint8_t id, uint16_t a, uint16_t b, uint16_t c);
+
+// Write one contiguous run of pending records; false when none are left
+extern bool log_drain(void);
+extern void log_flush(void);
+
+#endif // LOG_H
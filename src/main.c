@@ -8,203 +8,119 @@
 #include "opl.h"
 #include "track.h"
 #include "sound.h"
+#include "audio.h"
+#include "psg.h"
+#include "sched.h"
+#include "particles.h"
+#include "colliders.h"
 #include "ai.h"
 #include "collision.h"
 #include "hud.h"
 #include "racelogic.h"
 #include "racelogic.h"
 #include "layer2.h"
+#include "xram.h"
+#include "assets.h"
+#include "log.h"
+#include "pacing.h"
+#include "trace.h"
 #include <stdlib.h>
 
 unsigned REDRACER_CONFIG;    // RedRacer Sprite Configuration
-unsigned TRACK_MAP_START;    // Start of track map data in XRAM
-unsigned TRACK_MAP_END;      // End of track map data in XRAM
 unsigned TRACK_CONFIG;       // Track tilemap configuration
 unsigned TEXT_CONFIG;        // Text overlay configuration
 unsigned text_message_addr;  // Start address for text messages in XRAM
-unsigned text_storage_end;   // End address for text messages in XRAM
-unsigned TITLE_MAP_START;
-unsigned TITLE_MAP_END;
-unsigned TITLE_CONFIG;
+
+#if NUM_CARS > BOOT_MAX_CARS
+#error "The boot image has sprite configs for BOOT_MAX_CARS cars"
+#endif
 
 static void init_graphics(void)
 {
     // Initialize graphics here
     xregn(1, 0, 0, 1, 1); // 320x240 (4:3)
 
-
-    // Palette for the tile (16 colors)
-    uint16_t tile_palette[16] = {
-        0x0000,  // Index 0 (Transparent)
-        0x0020,
-        0x41A7,
-        0x1AE0,
-        0x72AA,
-        0x0038,
-        0x003E,
-        0x0372,
-        0x2C60,
-        0x35AE,
-        0x053C,
-        0x073E,
-        0x93AE,
-        0xC4B4,
-        0xD534,
-        0xF7BE,
-    };
-
-    RIA.addr0 = PALETTE_ADDR;
-    RIA.step0 = 1;
-    for (int i = 0; i < 16; i++) {
-        RIA.rw0 = tile_palette[i] & 0xFF;
-        RIA.rw0 = tile_palette[i] >> 8;
-    }
-
-
-    REDRACER_CONFIG = SPRITE_DATA_END;
-
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, transform[0], 256); // SX  (Scale X)
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, transform[1], 0);   // SHY (Shear Y)
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, transform[2], 0);   // TX  (Translate X)
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, transform[3], 0);   // SHX (Shear X)
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, transform[4], 256); // SY  (Scale Y)
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, transform[5], 0);   // TY  (Translate Y)
-
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, x_pos_px, car.x >> 6);
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, y_pos_px, car.y >> 6);
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, xram_sprite_ptr, REDRACER_DATA);
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, log_size, 4); // 16x16
-    xram0_struct_set(REDRACER_CONFIG, vga_mode4_asprite_t, has_opacity_metadata, false);
-
-    #define NUM_AI_CARS 3
-    for (unsigned i = 0; i < NUM_AI_CARS; i++) {
-        unsigned config_addr = REDRACER_CONFIG + sizeof(vga_mode4_asprite_t) * (i + 1);
-        unsigned sprite_ptr = REDRACER_DATA + ((i + 1) * 0x200); // Each car sprite uses 0x200 bytes (4 tiles)
-        
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, transform[0], 256); // SX  (Scale X)
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, transform[1], 0);   // SHY (Shear Y)
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, transform[2], 0);   // TX  (Translate X)
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, transform[3], 0);   // SHX (Shear X)
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, transform[4], 256); // SY  (Scale Y)
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, transform[5], 0);   // TY  (Translate Y)
-
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, x_pos_px, (100 + i * 20));
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, y_pos_px, (100 + i * 20));
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, xram_sprite_ptr, sprite_ptr);
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, log_size, 4); // 16x16
-        xram0_struct_set(config_addr, vga_mode4_asprite_t, has_opacity_metadata, false);
+    // Palette, configs and a blank text plane were loaded with the ROM
+    // (tools/make_boot_image.py); only the plane enables are left to do
+    uint8_t tag[4];
+    xram_read(BOOT_TAG_ADDR, tag, sizeof(tag));
+    if (tag[0] != 'R' || tag[1] != 'M' || tag[2] != BOOT_IMAGE_VERSION || tag[3] != NUM_CARS) {
+        // The configs below would point the planes and sprites at garbage
+        log_event(LOG_BOOT_MISMATCH, tag[2], tag[3], NUM_CARS);
+        log_flush();
+        exit(1);
     }
 
-    xregn(1, 0, 1, 5, 4, 1, REDRACER_CONFIG, (NUM_AI_CARS + 1), 1); // Enable Racer sprite
-
-    // Track map offsets
-    TRACK_MAP_START = TRACK_MAP_ADDR;
-    TRACK_MAP_END   = (TRACK_MAP_START + TRACK_MAP_SIZE);
-    
-    // NOTE: world_map is now loaded by load_track_data() in init_all_systems()
-
-    TRACK_CONFIG = TRACK_DATA_END;
+    REDRACER_CONFIG = BOOT_SPRITE_CONFIGS;
+    TRACK_CONFIG = BOOT_TRACK_CONFIG; // Map and tile pointers: load_track_data()
+    TEXT_CONFIG = BOOT_TEXT_CONFIG;
+    text_message_addr = BOOT_TEXT_RAM;
 
-    int16_t cam_x = 260 - 160; // 100
-    int16_t cam_y = 60 - 120;  // -60 (will be clamped to 0)
-
-    if (cam_x < 0) cam_x = 0;
-    if (cam_x > 192) cam_x = 192; // (512 - 320)
-    if (cam_y < 0) cam_y = 0;
-    if (cam_y > 144) cam_y = 144; // (384 - 240)
-
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, x_wrap, false);
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, y_wrap, false);
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, x_pos_px, cam_x);
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, y_pos_px, cam_y);
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, width_tiles, TRACK_MAP_WIDTH_TILES);
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, height_tiles, TRACK_MAP_HEIGHT_TILES);
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, xram_data_ptr, TRACK_MAP_START);
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, xram_palette_ptr, PALETTE_ADDR);
-    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, xram_tile_ptr, TRACK_DATA);
+    // Everything past the boot image is carved out by the XRAM allocator
+    xram_init();
 
+    xregn(1, 0, 1, 5, 4, 1, REDRACER_CONFIG, NUM_CARS, 1); // Enable Racer sprite
     xregn(1, 0, 1, 4, 2, 0x02, TRACK_CONFIG, 0); // Enable sprited tilemap 
 
-    TEXT_CONFIG = TRACK_CONFIG + sizeof(vga_mode2_config_t);
-    text_message_addr = TEXT_CONFIG + sizeof(vga_mode1_config_t);
-    const unsigned bytes_per_char = 3; // we write 3 bytes per character into text RAM
-    unsigned text_storage_end = text_message_addr + MESSAGE_LENGTH * bytes_per_char;
-
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, x_wrap, 0);
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, y_wrap, 0);
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, x_pos_px, 0); //Bug: first char duplicated if not set to zero
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, y_pos_px, 5);
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, width_chars, MESSAGE_WIDTH);
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, height_chars, MESSAGE_HEIGHT);
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, xram_data_ptr, text_message_addr);
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, xram_palette_ptr, 0xFFFF);
-    xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, xram_font_ptr, 0xFFFF);
-
     // 4 parameters: text mode, 8-bit, config, plane
     xregn(1, 0, 1, 4, 1, 3, TEXT_CONFIG, 1);
 
-    // Clear message buffer to spaces
+    // Clear message buffer to spaces (text RAM already is)
     for (int i = 0; i < MESSAGE_LENGTH; ++i) message[i] = ' ';
 
-    // Now write the MESSAGE_LENGTH characters into text RAM (3 bytes per char)
-    RIA.addr0 = text_message_addr;
-    RIA.step0 = 1;
-    for (uint16_t i = 0; i < MESSAGE_LENGTH; i++) {
-        RIA.rw0 = ' ';
-        RIA.rw0 = HUD_COL_WHITE;
-        RIA.rw0 = HUD_COL_BG;
-    }
-
-    // Title map offsets
-    TITLE_MAP_START = TITLE_MAP_ADDR;
-    TITLE_MAP_END   = (TITLE_MAP_START + TITLE_MAP_SIZE);
-
-    TITLE_CONFIG = TITLE_DATA_END;
-
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, x_wrap, true);
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, y_wrap, true);
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, x_pos_px, 0);
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, y_pos_px, 0);
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, width_tiles, TITLE_MAP_WIDTH_TILES);
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, height_tiles, TITLE_MAP_HEIGHT_TILES);
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, xram_data_ptr, TITLE_MAP_START);
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, xram_palette_ptr, PALETTE_ADDR);
-    xram0_struct_set(TITLE_CONFIG, vga_mode2_config_t, xram_tile_ptr, TITLE_DATA);
-
-    xregn(1, 0, 1, 4, 2, 0x02, TITLE_CONFIG, 2); // Titles on 2   
-
-
-    printf("Redracer Data at 0x%04X\n", REDRACER_DATA);
-    printf("Redracer Config at 0x%04X\n", REDRACER_CONFIG);
-    printf("Track Config at 0x%04X\n", TRACK_CONFIG);
-    printf("Text Config at 0x%04X\n", TEXT_CONFIG);
-    printf("Text Messages at 0x%04X - 0x%04X\n", text_message_addr, text_storage_end);
-    printf("Title Map at 0x%04X - 0x%04X\n", TITLE_MAP_START, TITLE_MAP_END);
-    printf("Title Config at 0x%04X\n", TITLE_CONFIG);
-    printf("OPL Config = 0x%X\n", OPL_ADDR);
-    printf("GAME_PAD_CONFIG=0x%X\n", GAMEPAD_INPUT);
-    printf("KEYBOARD_CONFIG=0x%X\n", KEYBOARD_INPUT);
+    // Title plane (configs only; tiles and map load on first STATE_TITLE)
+    init_plane2();
 
+    // Smoke, sparks and dust sprites
+    init_particles();
 }
 
-#define SONG_HZ 60
 uint8_t vsync_last = 0;
-uint16_t timer_accumulator = 0;
-bool music_enabled = true;
 uint8_t last_video_state = 0xFF; // Initialize to a state that won't match immediately
 
 int16_t next_scroll_x = 0;
 int16_t next_scroll_y = 0;
 
+// --- Idle tasks (see sched.h) ---
+
+// Brings in map chunks around the camera on tracks bigger than the window
+static uint8_t task_map_stream(pt_t* pt) {
+    (void)pt;
+    TRACE_BEGIN(TR_MAP_STREAM);
+    track_stream_step(-next_scroll_x, -next_scroll_y);
+    TRACE_END(TR_MAP_STREAM);
+    return TASK_YIELD;
+}
+
+// Appends pending log records to the log file
+static uint8_t task_log_drain(pt_t* pt) {
+    (void)pt;
+    log_drain();
+    return TASK_YIELD;
+}
+
+static uint8_t task_hud_timer(pt_t* pt) {
+    (void)pt;
+    if (current_state == STATE_RACING) hud_draw_timer();
+    return TASK_YIELD;
+}
+
 void init_all_systems(void) {
     // Hardware Setup
     xregn(0, 0, 0, 1, KEYBOARD_INPUT);
     xregn(0, 0, 2, 1, GAMEPAD_INPUT);
     
+    // Loaders log from here on (see log.h)
+    log_init();
+
+    // Content hashes for the loaders (before any track/title load)
+    asset_manifest_load();
+
     // Game Logic Setup
     init_player();
     init_ai();
     init_graphics();
+    TRACE_INIT(); // XRAM ring, before the track takes its share
     load_track(current_track_id); 
     init_input_system();
 
@@ -212,60 +128,30 @@ void init_all_systems(void) {
     OPL_Config(1, OPL_ADDR);
     opl_init();
     init_opl2_engine_sound(); // Engine sound system
-    music_init(MUSIC_FILENAME);
-    // init_psg();
-}
-
-void process_audio_frame(void) {
-    if (!music_enabled) return;
-    
-    timer_accumulator += SONG_HZ;
-    while (timer_accumulator >= 60) {
-        update_music();
-        timer_accumulator -= 60;
-    }
-}
+    music_init(MUSIC_FILENAME); // Loads the song into XRAM
+    init_psg(); // Sound effects
 
-void resolve_all_collisions(void) {
-    // A. FULL PHYSICS: Player vs all 3 AI
-    // Keep your heavy resolve_car_collision function for these
-    // It should include the wall-checks and sound effects
-    for (int i = 0; i < NUM_AI_CARS; i++) {
-        resolve_player_ai_collision(&car, &ai_cars[i]); 
-    }
+    // Background work for the end of each frame
+    sched_init();
+    sched_add("map_stream", task_map_stream, 20000, 2);
+    sched_add("hud_timer", task_hud_timer, 6000, 10);
+    sched_add("log_drain", task_log_drain, 12000, 60);
 
-    // B. LIGHT REPULSION: AI vs each other
-    // Use the new optimized function that skips wall lookups
-    resolve_ai_ai_collision(&ai_cars[0], &ai_cars[1]);
-    resolve_ai_ai_collision(&ai_cars[1], &ai_cars[2]);
-    resolve_ai_ai_collision(&ai_cars[0], &ai_cars[2]);
+    // From here on music and engine sound run from the vsync IRQ
+    audio_start();
 }
 
 void update_camera_and_ui(void) {
-    int16_t car_px_x = car.x >> 6;
-    int16_t car_px_y = car.y >> 6;
-
-    // Center car, then clamp to map bounds (512x384 map, 320x240 screen)
-    int16_t target_x = 160 - car_px_x;
-    int16_t target_y = 120 - car_px_y;
-
-    if (target_x > 0) target_x = 0;
-    if (target_x < -192) target_x = -192; 
-    if (target_y > 0) target_y = 0;
-    if (target_y < -144) target_y = -144;
-
-    // Save for the START of the next frame
-    next_scroll_x = target_x;
-    next_scroll_y = target_y;
-
-    uint16_t player_speed = abs(car.vel_x) + abs(car.vel_y);
-    hud_refresh_stats(car.laps, player_speed);
+    update_camera(); // Sets next_scroll_x/y for the start of the next frame
 
+    uint16_t player_speed = abs(CAR_GET16(car_vx, PLAYER_SLOT)) + abs(CAR_GET16(car_vy, PLAYER_SLOT));
+    hud_refresh_stats(car_laps[PLAYER_SLOT], player_speed, player_position);
 }
 
 void debug_draw_waypoints(void) {
-    int16_t wx = (waypoints[car.current_waypoint].x + next_scroll_x) >> 3;
-    int16_t wy = (waypoints[car.current_waypoint].y + next_scroll_y) >> 3;
+    uint8_t wp = car_waypoint[PLAYER_SLOT];
+    int16_t wx = (waypoints[wp].x + next_scroll_x) >> 3;
+    int16_t wy = (waypoints[wp].y + next_scroll_y) >> 3;
     if (wx >= 0 && wx < 40 && wy >= 0 && wy < 30) {
         hud_print(wx, wy, "X", 10, 0); // Green X at the target
     }
@@ -282,28 +168,41 @@ int main(void) {
 
 
     while (1) {
-        // 1. SYNC
-        if (RIA.vsync == vsync_last) continue;
+        // 1. SYNC (background tasks use whatever is left of the frame)
+        TRACE_BEGIN(TR_SYNC);
+        sched_idle(vsync_last);
         vsync_last = RIA.vsync;
+        TRACE_END(TR_SYNC);
+        pacing_frame_start(vsync_last, current_state); // Spots dropped frames
 
         // 2. HARDWARE UPDATE (Immediate)
+        TRACE_BEGIN(TR_VIDEO);
         xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, x_pos_px, next_scroll_x);
         xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, y_pos_px, next_scroll_y);
+        track_update_bank(-next_scroll_x, -next_scroll_y);
 
         // Dynamic plane loading based on game state
         if (current_state != last_video_state) {
             if (current_state == STATE_TITLE) {
-                // Load Title Assets from Filesystem
-                load_plane2();
+                // Title tiles/map stay resident; this only re-points plane 2
+                show_title_plane();
             } 
             last_video_state = current_state;
         }
+        TRACE_END(TR_VIDEO);
+        pacing_mark(PACE_VIDEO);
 
-        // 3. AUDIO
-        process_audio_frame();
+        // 3. AUDIO: playback is in the IRQ, buffer refills are an idle task
 
         // 4. PHYSICS & LOGIC
+        TRACE_BEGIN(TR_INPUT);
         handle_input();
+        TRACE_POLL();
+        terrain_cache_prefetch(-next_scroll_x, -next_scroll_y); // Map rows under the cars
+        TRACE_END(TR_INPUT);
+        pacing_mark(PACE_INPUT);
+
+        TRACE_BEGIN(TR_LOGIC);
 
         switch (current_state) {
             case STATE_TITLE:
@@ -312,46 +211,52 @@ int main(void) {
 
             case STATE_COUNTDOWN:
                 update_race_logic(); // This handles the state_timer--
-                update_player(&car);
+                update_player();
                 update_ai();
                 break;
 
             case STATE_RACING: {
                 // Braces {} here fix the "label followed by declaration" warning
-                uint16_t player_frame_start_x = car.x;
-                uint16_t player_frame_start_y = car.y;
+                uint16_t player_frame_start_x = CAR_POS(car_x, PLAYER_SLOT);
+                uint16_t player_frame_start_y = CAR_POS(car_y, PLAYER_SLOT);
 
-                update_player(&car);
-                update_drs_system(&car); // DRS System update
+                // Moving gates and barriers re-register their boxes every frame
+                colliders_clear();
 
-                update_player_progress(); // Updates car.total_progress
+                TRACE_BEGIN(TR_PLAYER);
+                update_player();
+                update_drs_system(); // DRS System update
 
-                update_ai();
+                update_player_progress(); // Advances car_waypoint[PLAYER_SLOT]
+                TRACE_END(TR_PLAYER);
+                pacing_mark(PACE_PLAYER);
 
-                // Once every 16 frames, recalculate speed for all AI
-                if ((RIA.vsync & 15) == 0) {
-                    for (int i=0; i < NUM_AI_CARS; i++) {
-                        update_ai_rubberbanding(&ai_cars[i]);
-                    }
-                }
+                TRACE_BEGIN(TR_AI);
+                update_ai(); // Brains (and pace) as frame time allows
+                TRACE_END(TR_AI);
+                pacing_mark(PACE_AI);
 
+                TRACE_BEGIN(TR_COLLIDE);
                 resolve_all_collisions();
+                TRACE_END(TR_COLLIDE);
+                update_particles();
+                pacing_mark(PACE_COLLIDE);
 
                 // Failsafe: check if ramming pushed player into a wall
-                if (is_colliding_fast(car.x >> 6, car.y >> 6)) {
-                    car.x = player_frame_start_x;
-                    car.y = player_frame_start_y;
-                    car.vel_x = 0;
-                    car.vel_y = 0;
+                if (is_colliding_fast(CAR_POS(car_x, PLAYER_SLOT) >> 6, CAR_POS(car_y, PLAYER_SLOT) >> 6)) {
+                    CAR_SET16(car_x, PLAYER_SLOT, player_frame_start_x);
+                    CAR_SET16(car_y, PLAYER_SLOT, player_frame_start_y);
+                    CAR_SET16(car_vx, PLAYER_SLOT, 0);
+                    CAR_SET16(car_vy, PLAYER_SLOT, 0);
                 }
 
+                // Race order from the progress field (drives POS, DRS and rubberbanding)
+                update_race_progress();
+
                 // Tick the clock
                 update_race_timer();
                 
-                // Draw the clock (You can do this every frame, or every 10 frames to save CPU)
-                if ((RIA.vsync & 10) == 0) {
-                    hud_draw_timer();
-                }
+                // The clock is drawn by the hud_timer idle task
 
                 // finish off countdown if still active
                 if (state_timer > 0) {
@@ -360,23 +265,22 @@ int main(void) {
                 }
 
                 // Process lap logic
-                update_lap_logic(&car, true);
-                for (int i = 0; i < NUM_AI_CARS; i++) {
-                    update_lap_logic(&ai_cars[i].car, false);
+                for (uint8_t i = 0; i < NUM_CARS; i++) {
+                    update_lap_logic(i);
                 }
 
                 // --- CHECK FOR WINNER ---
                 // Only check if we don't have a winner yet
                 if (race_winner == 0xFF) {
-                    if (car.laps >= 5) {
+                    if (car_laps[PLAYER_SLOT] >= 5) {
                         race_winner = 0; // Player ID
                         stop_engine_sound();
                         current_state = STATE_FINISHED;
                         state_timer = 300;
                     } else {
-                        for (uint8_t i = 0; i < NUM_AI_CARS; i++) {
-                            if (ai_cars[i].car.laps >= 5) {
-                                race_winner = i + 1; // AI ID
+                        for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+                            if (car_laps[i] >= 5) {
+                                race_winner = i; // AI ID (car slot)
                                 stop_engine_sound();
                                 current_state = STATE_FINISHED;
                                 state_timer = 300;
@@ -384,6 +288,15 @@ int main(void) {
                             }
                         }
                     }
+                    if (race_winner != 0xFF) {
+                        sched_log_stats();
+                        log_event(LOG_AI_BRAINS, ai_brains_run, ai_brains_forced, 0);
+                        log_event(LOG_TERRAIN_CACHE, terrain_cache_misses, terrain_cache_fills,
+                                  track_chunks_forced);
+                        log_event(LOG_RECORDS_DROPPED, log_dropped, 0, 0);
+                        pacing_race_end(current_track_id);
+                        log_flush();
+                    }
                 }
             } break;
 
@@ -393,22 +306,27 @@ int main(void) {
 
             case STATE_GAMEOVER:
                 // Handle high scores or waiting for reset
-                if (is_action_pressed(0, ACTION_PAUSE)) {
+                if (is_action_just_pressed(0, ACTION_PAUSE)) {
                     reset_race();
                 }
                 break;
         } 
+        TRACE_END(TR_LOGIC);
 
         // 5. POST-PROCESS (Camera & UI)
+        TRACE_BEGIN(TR_DRAW);
         update_camera_and_ui();
-        hud_draw_drs(&car); 
+        hud_draw_drs(); 
 
         // 6. RENDER PREP
-        int16_t screen_x = (car.x >> 6) + next_scroll_x;
-        int16_t screen_y = (car.y >> 6) + next_scroll_y;
+        int16_t screen_x = (CAR_POS(car_x, PLAYER_SLOT) >> 6) + next_scroll_x;
+        int16_t screen_y = (CAR_POS(car_y, PLAYER_SLOT) >> 6) + next_scroll_y;
         
-        draw_player(&car, screen_x, screen_y);
+        draw_player(screen_x, screen_y);
         draw_ai_cars(next_scroll_x, next_scroll_y);
+        draw_particles(next_scroll_x, next_scroll_y);
+        TRACE_END(TR_DRAW);
+        pacing_mark(PACE_LOGIC);
     }
     return 0;
 }
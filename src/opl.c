@@ -4,18 +4,30 @@
 #include <stdio.h>
 #include "opl.h"
 #include "instruments.h"
+#include "voices.h"
 #include "constants.h"
 
-#include <errno.h>
-
-#include <fcntl.h>
-#include <unistd.h>
-
-// F-Number table for Octave 4 @ 4.0 MHz
-const uint16_t fnum_table[12] = {
-    308, 325, 345, 365, 387, 410, 434, 460, 487, 516, 547, 579
+// Block/F-Number for every MIDI note (F-Numbers for 4.0 MHz, octave 4 row
+// repeated per block). High byte: Block << 2 | F-Number bits 8-9, low byte:
+// F-Number bits 0-7. Notes below 12 clamp to 12, blocks above 7 to 7.
+const uint16_t midi_freq_table[128] = {
+    0x0134, 0x0134, 0x0134, 0x0134, 0x0134, 0x0134, 0x0134, 0x0134, 0x0134, 0x0134, 0x0134, 0x0134,
+    0x0134, 0x0145, 0x0159, 0x016D, 0x0183, 0x019A, 0x01B2, 0x01CC, 0x01E7, 0x0204, 0x0223, 0x0243,
+    0x0534, 0x0545, 0x0559, 0x056D, 0x0583, 0x059A, 0x05B2, 0x05CC, 0x05E7, 0x0604, 0x0623, 0x0643,
+    0x0934, 0x0945, 0x0959, 0x096D, 0x0983, 0x099A, 0x09B2, 0x09CC, 0x09E7, 0x0A04, 0x0A23, 0x0A43,
+    0x0D34, 0x0D45, 0x0D59, 0x0D6D, 0x0D83, 0x0D9A, 0x0DB2, 0x0DCC, 0x0DE7, 0x0E04, 0x0E23, 0x0E43,
+    0x1134, 0x1145, 0x1159, 0x116D, 0x1183, 0x119A, 0x11B2, 0x11CC, 0x11E7, 0x1204, 0x1223, 0x1243,
+    0x1534, 0x1545, 0x1559, 0x156D, 0x1583, 0x159A, 0x15B2, 0x15CC, 0x15E7, 0x1604, 0x1623, 0x1643,
+    0x1934, 0x1945, 0x1959, 0x196D, 0x1983, 0x199A, 0x19B2, 0x19CC, 0x19E7, 0x1A04, 0x1A23, 0x1A43,
+    0x1D34, 0x1D45, 0x1D59, 0x1D6D, 0x1D83, 0x1D9A, 0x1DB2, 0x1DCC, 0x1DE7, 0x1E04, 0x1E23, 0x1E43,
+    0x1D34, 0x1D45, 0x1D59, 0x1D6D, 0x1D83, 0x1D9A, 0x1DB2, 0x1DCC, 0x1DE7, 0x1E04, 0x1E23, 0x1E43,
+    0x1D34, 0x1D45, 0x1D59, 0x1D6D, 0x1D83, 0x1D9A, 0x1DB2, 0x1DCC,
 };
 
+// Operator slot offsets per channel (modulator, carrier)
+const uint8_t opl_mod_offsets[9] = {0x00,0x01,0x02,0x08,0x09,0x0A,0x10,0x11,0x12};
+const uint8_t opl_car_offsets[9] = {0x03,0x04,0x05,0x0B,0x0C,0x0D,0x13,0x14,0x15};
+
 uint8_t channel_is_drum[9] = {0,0,0,0,0,0,0,0,0}; 
 
 // Shadow registers for all 9 channels
@@ -30,18 +42,7 @@ uint8_t shadow_ksl_c[9];
 // High Byte: 0x20 (KeyOn) | Block << 2 | F-Number High (2 bits)
 // Low Byte: F-Number Low (8 bits)
 uint16_t midi_to_opl_freq(uint8_t midi_note) {
-    if (midi_note < 12) midi_note = 12;
-    
-    int block = (midi_note - 12) / 12;
-    int note_idx = (midi_note - 12) % 12;
-    
-    if (block > 7) block = 7;
-
-    uint16_t f_num = fnum_table[note_idx];
-    uint8_t high_byte = 0x20 | (block << 2) | ((f_num >> 8) & 0x03);
-    uint8_t low_byte = f_num & 0xFF;
-
-    return (high_byte << 8) | low_byte;
+    return midi_freq_table[midi_note & 0x7F] | 0x2000;
 }
 
 void opl_write(uint8_t reg, uint8_t data) {
@@ -79,15 +80,16 @@ void OPL_NoteOn(uint8_t channel, uint8_t midi_note) {
         midi_note = 60; 
     }
     
+    // Music helpers go through the voice manager (remapped if an SFX holds the channel)
     uint16_t freq = midi_to_opl_freq(midi_note);
-    opl_write(0xA0 + channel, freq & 0xFF);
-    opl_write(0xB0 + channel, (freq >> 8) & 0xFF);
-    shadow_b0[channel] = (freq >> 8) & 0x1F;
+    opl_music_write(0xA0 + channel, freq & 0xFF);
+    opl_music_write(0xB0 + channel, (freq >> 8) & 0xFF);
 }
 
 void OPL_NoteOff(uint8_t channel) {
     if (channel > 8) return;
-    opl_write(0xB0 + channel, shadow_b0[channel]); // Write stored octave/freq with KeyOn=0
+    // Write stored octave/freq with KeyOn=0
+    opl_music_write(0xB0 + channel, opl_music_read(0xB0 + channel) & 0x1F);
 }
 
 // Clear all 256 registers correctly
@@ -104,12 +106,9 @@ void OPL_SetVolume(uint8_t chan, uint8_t velocity) {
     // Formula: 63 - (velocity / 2)
     uint8_t vol = 63 - (velocity >> 1);
     
-    static const uint8_t mod_offsets[] = {0x00,0x01,0x02,0x08,0x09,0x0A,0x10,0x11,0x12};
-    static const uint8_t car_offsets[] = {0x03,0x04,0x05,0x0B,0x0C,0x0D,0x13,0x14,0x15};
-    
     // Write to Carrier (this affects the audible volume most)
     // Mask with 0xC0 to preserve Key Scale Level bits
-    opl_write(0x40 + car_offsets[chan], (shadow_ksl_c[chan] & 0xC0) | vol);
+    opl_music_write(0x40 + opl_car_offsets[chan], (shadow_ksl_c[chan] & 0xC0) | vol);
 }
 
 void opl_init() {
@@ -135,6 +134,9 @@ void opl_init() {
     // 3. Re-enable the features we need
     opl_write(0x01, 0x20); // Enable Waveform Select
     opl_write(0xBD, 0x00); // Ensure Melodic Mode
+
+    // Every channel starts out belonging to the music
+    voices_init();
 }
 
 void opl_silence() {
@@ -175,91 +177,23 @@ void OPL_Config(uint8_t enable, uint16_t addr) {
     
 }
 
-static int music_fd = -1;
-static uint8_t music_buffer[512];
-static uint16_t music_buf_idx = 0;
-static uint16_t music_bytes_ready = 0; 
-static uint16_t music_wait_ticks = 0;
-static bool music_error_state = false;
+// The music is a note-level song (sequencer.c). It sits in XRAM and plays
+// from the vsync IRQ, so the main loop does no music I/O at all.
+volatile bool music_silence_pending = false; // Key off the music on the next tick
 
 void music_init(const char* filename) {
-    if (music_fd >= 0) close(music_fd);
-    music_fd = open(filename, O_RDONLY);
-    
-    music_buf_idx = 0;
-    music_wait_ticks = 0;
-    music_error_state = (music_fd < 0);
-
-    if (music_error_state) {
-        printf("Music: Failed to open %s\n", filename);
-        return;
-    }
-
-    // 1. Read into the START of the buffer (index 0)
-    int res = read(music_fd, music_buffer, 512);
-                
-    if (res < 0) {
-        int err = errno;
-        printf("Music: Initial Read Error %d\n", err);
-        music_error_state = true;
-        return;
-    }
+    song_play(filename);
+}
 
-    // 2. IMPORTANT: Update the count of valid bytes in the buffer
-    // Without this, the sequencer thinks the buffer is empty!
-    music_bytes_ready = res; 
-    
-   //  printf("Music: Started. Initialized with %d bytes.\n", res);
+void music_stop(void) {
+    song_stop();
 }
 
+// Vsync IRQ: one 60Hz tick
 void update_music() {
-    if (music_error_state || music_fd < 0) return;
-
-    if (music_wait_ticks > 0) {
-        music_wait_ticks--;
-    }
-
-    if (music_wait_ticks == 0) {
-        while (music_wait_ticks == 0) {
-
-            if (music_buf_idx >= 512){
-                // printf("Music: Buffer Refill Triggered.\n");
-                
-                int res = read(music_fd, &music_buffer, 512);
-                
-                if (res < 0) {
-                    int err = errno;
-                    printf("Music: Read Error %d\n", err);
-                    music_error_state = true;
-                    return;
-                }
-
-                music_buf_idx = 0;
-            }
-
-            // --- 4-BYTE PACKET ACCESS ---
-            uint8_t reg  = music_buffer[music_buf_idx++];
-            uint8_t val  = music_buffer[music_buf_idx++];
-            uint8_t d_lo = music_buffer[music_buf_idx++];
-            uint8_t d_hi = music_buffer[music_buf_idx++];
-            uint16_t delay = ((uint16_t)d_hi << 8) | d_lo;
-
-
-            if (reg == 0xFF && val == 0xFF) {
-                off_t seek_res = lseek(music_fd, 0, SEEK_SET);
-
-                printf("Music: Looping to start of track.\n");
-                music_buf_idx = 512; // Force buffer reload
-                delay = 1; // Small delay after loop
-
-            } else {
-                opl_write(reg, val);
-            }
-
-            if (delay > 0) {
-                music_wait_ticks = delay;
-            }
-
-        }
+    if (music_silence_pending) {
+        opl_music_silence();
+        music_silence_pending = false;
     }
+    update_song();
 }
@@ -1,37 +1,60 @@
 #ifndef OPL_H
 #define OPL_H
 
-#define MUSIC_FILENAME "ROM:DEMO.BIN"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MUSIC_FILENAME "ROM:DEMO.SNG" // Built from music/DEMO.BIN (CMakeLists.txt)
+
+// Note-level songs (see sequencer.c and tools/midi_to_opl.py --events)
+#define SONG_NOTE_OFF  0
+#define SONG_NOTE_ON   1
+#define SONG_WAIT      2    // Nothing; splits rests longer than 65535 ms
+#define SONG_PATCH     3    // note = gm_bank program, or SONG_DRUM_* below
+#define SONG_END       0xFF // Loop back to the first event
+
+#define SONG_DRUM_BD    128
+#define SONG_DRUM_SNARE 129
+#define SONG_DRUM_HIHAT 130
 
 typedef struct {
-    uint16_t delay_ms; 
-    uint8_t type;      // 0: Off, 1: On, 3: Patch
+    uint16_t delay_ms; // Since the previous event
+    uint8_t type;      // SONG_*
     uint8_t channel;   
     uint8_t note;      
-    uint8_t velocity;  // Unused for now
+    uint8_t velocity;  // Note on only
 } SongEvent;
 
+extern const uint8_t opl_mod_offsets[9];
+extern const uint8_t opl_car_offsets[9];
+
 extern uint8_t shadow_b0[9]; 
 extern uint8_t shadow_ksl_m[9];
 extern uint8_t shadow_ksl_c[9];
 
-extern uint16_t current_event_idx;
-extern uint16_t ticks_until_next_event;
+extern const uint16_t midi_freq_table[128];
+extern uint8_t channel_is_drum[9];
 
 extern void OPL_NoteOn(uint8_t channel, uint8_t midi_note);
 extern void OPL_NoteOff(uint8_t channel);
 extern void opl_clear();
 extern void opl_write(uint8_t reg, uint8_t value);
-extern void update_music();
+extern void update_music(); // Vsync IRQ
 extern void OPL_SetVolume(uint8_t chan, uint8_t velocity);
 extern void opl_init();
 extern void opl_fifo_clear();
 extern void opl_silence_all();
 extern void OPL_Config(uint8_t enable, uint16_t addr);
-extern void music_refill_buffer();
 // extern void debug_test_lseek();
 // extern void shutdown_audio();
 
 extern void music_init(const char* filename);
+extern void music_stop(void);
+extern volatile bool music_silence_pending;
+
+// Note-level sequencer: loads the whole song to XRAM, plays it from the IRQ
+extern void song_play(const char* filename);
+extern void song_stop(void);
+extern void update_song(void); // From update_music
 
 #endif // OPL_H
\ No newline at end of file
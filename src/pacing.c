@@ -0,0 +1,117 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "pacing.h"
+#include "sched.h"
+#include "log.h"
+#include "trace.h"
+
+static const char* const stage_names[PACE_STAGES] = {
+    "video", "input", "player", "ai", "collide", "logic", "tasks",
+};
+
+uint16_t pacing_bins[PACING_BINS];
+uint16_t pacing_drops[PACE_STAGES];
+char pacing_summary[32];
+uint16_t pacing_prev_units[PACE_STAGES];
+
+static uint16_t stage_units[PACE_STAGES]; // Current frame, 256-cycle units
+static uint16_t mark_last;
+static uint8_t vsync_prev;
+static uint8_t frame_state;               // Game state of the current frame
+static bool resync = true;                // Next interval isn't a real frame
+
+void pacing_reset(void) {
+    memset(pacing_bins, 0, sizeof(pacing_bins));
+    memset(pacing_drops, 0, sizeof(pacing_drops));
+    resync = true; // The track load before the race would count as a drop
+}
+
+static uint8_t heaviest_stage(void) {
+    uint8_t heaviest = 0;
+    for (uint8_t i = 1; i < PACE_STAGES; i++) {
+        if (stage_units[i] > stage_units[heaviest]) heaviest = i;
+    }
+    return heaviest;
+}
+
+void pacing_frame_start(uint8_t vsync, uint8_t state) {
+    // The idle steps just run close the previous frame
+    stage_units[PACE_TASKS] = sched_busy;
+
+    if (!resync) {
+        uint8_t interval = vsync - vsync_prev;
+        uint8_t bin = interval ? interval - 1 : 0;
+        if (bin >= PACING_BINS) bin = PACING_BINS - 1;
+        if (pacing_bins[bin] < 0xFFFF) pacing_bins[bin]++;
+
+        if (interval > 1) {
+            uint8_t stage = heaviest_stage();
+            pacing_drops[stage]++;
+            log_event(LOG_FRAME_DROP, interval - 1, frame_state, stage);
+            TRACE_DROP(); // Keeps the frame in the trace ring
+        }
+    }
+    resync = false;
+    vsync_prev = vsync;
+    frame_state = state;
+
+    memcpy(pacing_prev_units, stage_units, sizeof(stage_units));
+    memset(stage_units, 0, sizeof(stage_units));
+    mark_last = sched_frame_elapsed();
+}
+
+void pacing_mark(uint8_t stage) {
+    uint16_t now = sched_frame_elapsed();
+    // The vsync IRQ restarts the timer, so a stage that ran past it reads low
+    uint16_t units = (now >= mark_last) ? now - mark_last : now + SCHED_FRAME_UNITS - mark_last;
+    stage_units[stage] += units;
+    mark_last = now;
+}
+
+// Worst case is about 210 characters (every count at 65535)
+static char line[256];
+static uint16_t line_len;
+
+// snprintf returns the length it wanted, so clamp to what actually fit
+static void line_append(const char* fmt, ...) {
+    if (line_len >= sizeof(line) - 1) return;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(line + line_len, sizeof(line) - line_len, fmt, args);
+    va_end(args);
+    if (n < 0) return;
+    line_len += n;
+    if (line_len > sizeof(line) - 1) line_len = sizeof(line) - 1;
+}
+
+void pacing_race_end(uint8_t track_id) {
+    uint16_t frames = 0;
+    uint16_t dropped = 0;
+    for (uint8_t i = 0; i < PACING_BINS; i++) {
+        frames += pacing_bins[i];
+        dropped += pacing_bins[i] * i; // The last bin counts as its minimum
+    }
+    snprintf(pacing_summary, sizeof(pacing_summary), " %u FRAMES %u DROPPED ", frames, dropped);
+
+    // One line per race, written in one go
+    line_len = 0;
+    line_append("track %u: %u frames, %u dropped; intervals", track_id, frames, dropped);
+    for (uint8_t i = 0; i < PACING_BINS; i++) {
+        line_append(" %u%s:%u", i + 1, (i == PACING_BINS - 1) ? "+" : "", pacing_bins[i]);
+    }
+    line_append("; heaviest");
+    for (uint8_t i = 0; i < PACE_STAGES; i++) {
+        line_append(" %s:%u", stage_names[i], pacing_drops[i]);
+    }
+    line_append("\n");
+
+    int fd = open(PACING_FILE, O_WRONLY | O_CREAT | O_APPEND);
+    if (fd < 0) return;
+    write(fd, line, line_len);
+    close(fd);
+}
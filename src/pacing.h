@@ -0,0 +1,44 @@
+#ifndef PACING_H
+#define PACING_H
+
+#include <stdint.h>
+
+// Frame pacing monitor.
+//
+// The main loop marks the end of each stage with pacing_mark(). When
+// RIA.vsync has moved by more than one since the previous loop, frames were
+// dropped: the drop is logged (LOG_FRAME_DROP) with the game state and the
+// stage that took longest in the frame that overran. Frame-to-frame
+// intervals go into a histogram that is cleared by reset_race(). At race
+// end pacing_race_end() appends one line per race to PACING_FILE in a
+// single write and builds the results-screen summary.
+
+#define PACING_FILE "pacing.txt"
+#define PACING_BINS 8 // Intervals of 1..7 frames; the last bin is 8 or more
+
+// Numbered as in the log (see pacing.c for the names)
+enum {
+    PACE_VIDEO,   // Scroll, bank and plane writes
+    PACE_INPUT,   // Input and terrain row prefetch
+    PACE_PLAYER,  // Player physics, DRS and progress
+    PACE_AI,
+    PACE_COLLIDE, // Car-to-car collisions and particles
+    PACE_LOGIC,   // Rest of the state update, camera, HUD and sprites
+    PACE_TASKS,   // Idle-task steps (sched_idle)
+    PACE_STAGES
+};
+
+extern uint16_t pacing_bins[PACING_BINS];  // [i]: intervals of i + 1 frames
+extern uint16_t pacing_drops[PACE_STAGES]; // Drops by heaviest stage
+extern char pacing_summary[32];            // " n FRAMES n DROPPED " (results screen)
+extern uint16_t pacing_prev_units[PACE_STAGES]; // Last frame's stages, 256-cycle units
+
+extern void pacing_reset(void);
+
+// Top of the loop, right after sched_idle()
+extern void pacing_frame_start(uint8_t vsync, uint8_t state);
+extern void pacing_mark(uint8_t stage);
+
+extern void pacing_race_end(uint8_t track_id);
+
+#endif // PACING_H
@@ -0,0 +1,175 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "particles.h"
+#include "constants.h"
+#include "xram.h"
+
+#define PARTICLE_PLANE 0  // Sprite plane 0: over the track, under the cars
+#define PARTICLE_SIZE  8
+#define IMAGE_BYTES    (PARTICLE_SIZE * PARTICLE_SIZE * 2) // 16bpp
+#define HIDDEN_Y       (-PARTICLE_SIZE)
+
+// Sprite images, generated at init
+enum { IMG_SMOKE_BIG, IMG_SMOKE_SMALL, IMG_SPARK, IMG_DUST, IMG_COUNT };
+
+typedef struct {
+    uint8_t radius2; // Twice the blob radius in pixels
+    uint16_t color;  // RGB555 with the opaque bit (0x0020)
+} ParticleImage;
+
+static const ParticleImage images[IMG_COUNT] = {
+    {7, 0x9CF3 | 0x0020}, // Grey
+    {4, 0xBDF7 | 0x0020}, // Light grey
+    {3, 0x07BF | 0x0020}, // Yellow-white
+    {5, 0x2A95 | 0x0020}, // Brown
+};
+
+typedef struct {
+    uint8_t life;      // Frames
+    uint8_t img_young;
+    uint8_t img_old;   // Used for the last quarter of the life
+    uint8_t spread;    // Random velocity range (1/16 px per frame)
+    uint8_t drag;      // Velocity loses 1/2^drag per frame
+} ParticleType;
+
+static const ParticleType types[PART_TYPES] = {
+    {24, IMG_SMOKE_BIG, IMG_SMOKE_SMALL, 8,  3}, // PART_SMOKE
+    {10, IMG_SPARK,     IMG_SPARK,       40, 2}, // PART_SPARK
+    {16, IMG_DUST,      IMG_DUST,        12, 2}, // PART_DUST
+};
+
+// Pool as parallel arrays, like the car slots (cars.h)
+static int16_t part_x[PARTICLE_MAX];  // World position, 12.4 fixed point
+static int16_t part_y[PARTICLE_MAX];
+static int8_t part_vx[PARTICLE_MAX];  // 1/16 px per frame
+static int8_t part_vy[PARTICLE_MAX];
+static uint8_t part_life[PARTICLE_MAX]; // 0 = free
+static uint8_t part_type[PARTICLE_MAX];
+static bool part_shown[PARTICLE_MAX];   // Sprite currently on screen
+
+static uint8_t next_slot = 0;    // Ring: always the slot spawned longest ago
+static uint8_t spawn_budget = PARTICLE_SPAWN_BUDGET;
+static uint8_t rng = 0x5A;
+uint16_t particles_dropped = 0;
+
+static unsigned particle_config;
+static uint16_t image_addr;
+
+// 8-bit xorshift; plenty for scattering sparks
+static uint8_t next_random(void) {
+    rng ^= rng << 3;
+    rng ^= rng >> 5;
+    rng ^= rng << 1;
+    return rng;
+}
+
+void init_particles(void) {
+    particle_config = xram_alloc("particle configs", sizeof(vga_mode4_sprite_t) * PARTICLE_MAX);
+    image_addr = xram_alloc("particle sprites", IMAGE_BYTES * IMG_COUNT);
+    if (particle_config == XRAM_NULL || image_addr == XRAM_NULL) return;
+
+    // Round blobs centred in the 8x8 cell (coordinates doubled to stay integer)
+    RIA.addr0 = image_addr;
+    RIA.step0 = 1;
+    for (uint8_t img = 0; img < IMG_COUNT; img++) {
+        uint8_t r2 = images[img].radius2;
+        for (int8_t y = 0; y < PARTICLE_SIZE; y++) {
+            for (int8_t x = 0; x < PARTICLE_SIZE; x++) {
+                int8_t dx = 2 * x - (PARTICLE_SIZE - 1);
+                int8_t dy = 2 * y - (PARTICLE_SIZE - 1);
+                uint16_t c = (dx * dx + dy * dy <= r2 * r2) ? images[img].color : 0;
+                RIA.rw0 = c & 0xFF;
+                RIA.rw0 = c >> 8;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < PARTICLE_MAX; i++) {
+        unsigned config = particle_config + sizeof(vga_mode4_sprite_t) * i;
+        xram0_struct_set(config, vga_mode4_sprite_t, x_pos_px, 0);
+        xram0_struct_set(config, vga_mode4_sprite_t, y_pos_px, HIDDEN_Y);
+        xram0_struct_set(config, vga_mode4_sprite_t, xram_sprite_ptr, image_addr);
+        xram0_struct_set(config, vga_mode4_sprite_t, log_size, 3); // 8x8
+        xram0_struct_set(config, vga_mode4_sprite_t, has_opacity_metadata, false);
+    }
+    particles_clear();
+
+    xregn(1, 0, 1, 5, 4, 0, particle_config, PARTICLE_MAX, PARTICLE_PLANE);
+}
+
+void particles_clear(void) {
+    for (uint8_t i = 0; i < PARTICLE_MAX; i++) {
+        part_life[i] = 0;
+        part_shown[i] = true; // Forces the hide write on the next draw
+    }
+}
+
+void particle_spawn(uint8_t type, int16_t px, int16_t py, uint8_t count) {
+    const ParticleType *t = &types[type];
+    while (count--) {
+        if (spawn_budget == 0) {
+            particles_dropped++;
+            continue;
+        }
+        spawn_budget--;
+
+        uint8_t i = next_slot;
+        if (++next_slot >= PARTICLE_MAX) next_slot = 0;
+
+        // Sprite's top-left, so the blob sits on the given point
+        part_x[i] = (px - PARTICLE_SIZE / 2) << 4;
+        part_y[i] = (py - PARTICLE_SIZE / 2) << 4;
+        part_vx[i] = (int8_t)((next_random() % (2 * t->spread + 1)) - t->spread);
+        part_vy[i] = (int8_t)((next_random() % (2 * t->spread + 1)) - t->spread);
+        part_life[i] = t->life;
+        part_type[i] = type;
+    }
+}
+
+void update_particles(void) {
+    spawn_budget = PARTICLE_SPAWN_BUDGET;
+
+    for (uint8_t i = 0; i < PARTICLE_MAX; i++) {
+        if (part_life[i] == 0) continue;
+        part_life[i]--;
+
+        int8_t vx = part_vx[i];
+        int8_t vy = part_vy[i];
+        part_x[i] += vx;
+        part_y[i] += vy;
+
+        uint8_t drag = types[part_type[i]].drag;
+        part_vx[i] = vx - (vx >> drag);
+        part_vy[i] = vy - (vy >> drag);
+    }
+}
+
+void draw_particles(int16_t scroll_x, int16_t scroll_y) {
+    if (particle_config == XRAM_NULL) return;
+
+    unsigned config = particle_config;
+    for (uint8_t i = 0; i < PARTICLE_MAX; i++, config += sizeof(vga_mode4_sprite_t)) {
+        if (part_life[i] == 0) {
+            // Park it off screen once, then leave it alone
+            if (part_shown[i]) {
+                xram0_struct_set(config, vga_mode4_sprite_t, y_pos_px, HIDDEN_Y);
+                part_shown[i] = false;
+            }
+            continue;
+        }
+
+        const ParticleType *t = &types[part_type[i]];
+        uint8_t img = (part_life[i] < (t->life >> 2)) ? t->img_old : t->img_young;
+        int16_t sx = (part_x[i] >> 4) + scroll_x;
+        int16_t sy = (part_y[i] >> 4) + scroll_y;
+        uint16_t ptr = image_addr + IMAGE_BYTES * img;
+
+        RIA.addr0 = config;
+        RIA.step0 = 1;
+        RIA.rw0 = sx & 0xFF;  RIA.rw0 = sx >> 8;
+        RIA.rw0 = sy & 0xFF;  RIA.rw0 = sy >> 8;
+        RIA.rw0 = ptr & 0xFF; RIA.rw0 = ptr >> 8;
+        part_shown[i] = true;
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <stdint.h>
+
+// Fixed pool of short-lived effects (tyre smoke, sparks, dust), drawn as
+// 8x8 sprites on sprite plane 0, under the cars.
+//
+// Spawns are capped per frame and always reuse the slot spawned longest
+// ago, so a pile-up costs the same as a quiet lap: PARTICLE_MAX updates and
+// sprite writes, never more.
+
+#define PARTICLE_MAX          16
+#define PARTICLE_SPAWN_BUDGET 6  // New particles per frame; the rest are dropped
+
+enum {
+    PART_SMOKE, // Tyre smoke and DRS exhaust
+    PART_SPARK, // Wall and car contacts
+    PART_DUST,  // Driving on grass
+    PART_TYPES
+};
+
+extern void init_particles(void);
+extern void particles_clear(void);
+
+// World pixel position (car centre); count is capped by the frame budget
+extern void particle_spawn(uint8_t type, int16_t px, int16_t py, uint8_t count);
+
+extern void update_particles(void);
+extern void draw_particles(int16_t scroll_x, int16_t scroll_y);
+
+extern uint16_t particles_dropped; // Spawns refused by the frame budget
+
+#endif // PARTICLES_H
@@ -6,14 +6,19 @@
 #include <stdlib.h>
 #include "track.h"
 #include "sound.h"
-#include <stdio.h>
+#include "audio.h"
+#include "particles.h"
 #include "ai.h"
 #include "racelogic.h"
 #include "hud.h"
+#include "log.h"
 
 // External Sin table
 extern const int8_t SIN_LUT[256];
-Car car = {0};
+
+// DRS System (player only)
+uint16_t drs_charge = 0;
+uint8_t drs_active_timer = 0;
 
 // Pre-calculated Sin table (scaled to 127)
 const int8_t SIN_LUT[256] = {
@@ -73,16 +78,13 @@ const int16_t TY_LUT[256] = {
       944,   880,   816,   752,   688,   624,   560,   512,   448,   384,   336,   272,   224,   176,   128,    80,
 };
 
-// Track last known position for stuck detection
-uint8_t rebound_timer = 0;
-
-void rescue_player(Car *p) {
+void rescue_player(void) {
     uint8_t best_wp = 0;
     uint32_t min_dist = 0xFFFFFFFF; // Start with max possible 32-bit value
 
     // Current player position in pixels
-    int16_t px = p->x >> 6;
-    int16_t py = p->y >> 6;
+    int16_t px = CAR_POS(car_x, PLAYER_SLOT) >> 6;
+    int16_t py = CAR_POS(car_y, PLAYER_SLOT) >> 6;
 
     // 1. Find the geographically nearest waypoint
     for (uint8_t i = 0; i < g_num_active_waypoints; i++) {
@@ -100,13 +102,13 @@ void rescue_player(Car *p) {
     }
 
     // 2. Teleport to the center of that waypoint
-    p->x = (uint16_t)waypoints[best_wp].x << 6;
-    p->y = (uint16_t)waypoints[best_wp].y << 6;
+    CAR_SET16(car_x, PLAYER_SLOT, (uint16_t)waypoints[best_wp].x << 6);
+    CAR_SET16(car_y, PLAYER_SLOT, (uint16_t)waypoints[best_wp].y << 6);
 
     // 3. Reset physics state
-    p->vel_x = 0;
-    p->vel_y = 0;
-    rebound_timer = 0;
+    CAR_SET16(car_vx, PLAYER_SLOT, 0);
+    CAR_SET16(car_vy, PLAYER_SLOT, 0);
+    car_rebound[PLAYER_SLOT] = 0;
 
     // 4. Set orientation
     // Point the car toward the NEXT waypoint in the sequence
@@ -118,22 +120,21 @@ void rescue_player(Car *p) {
     // Use your atan2 logic to get the angle (standard 0=Right)
     uint8_t standard_angle = atan2_8(ndy, ndx);
     // Convert to your CCW 0=Up system: (192 - standard)
-    p->angle = (192 - standard_angle) & 0xFF;
+    car_angle[PLAYER_SLOT] = (192 - standard_angle) & 0xFF;
     
-    printf("Rescued to WP %d\n", best_wp);
+    log_event(LOG_RESCUE, best_wp, 0, 0);
 }
 
+static uint8_t slick_timer = 0;   // Frames left sliding on oil
+static uint8_t last_trigger = TRIGGER_NONE; // Triggers fire on the way in
+
 void init_player(void) {
     // 245 pixels in 10.6 is 245 << 6
-    car.x = 245 << 6;  
-    car.y = 70 << 6;   
-    car.vel_x = 0;
-    car.vel_y = 0;
-    car.angle = 64; 
-    car.laps = 0;
-    car.next_checkpoint = 1; // They've started, looking for CP1
-    car.drs_charge = 0;
-    car.drs_active_timer = 0;
+    reset_car(PLAYER_SLOT, 245, 70, 64);
+    drs_charge = 0;
+    drs_active_timer = 0;
+    slick_timer = 0;
+    last_trigger = TRIGGER_NONE;
 }
 
 // OPTIMIZED: Checks 4 corners using 16-bit pixel coordinates
@@ -158,57 +159,68 @@ uint8_t is_colliding_fast(int16_t px, int16_t py) {
 }
 
 uint8_t rescue_cooldown = 0;
+static uint8_t skid_cooldown = 0; // Frames until the screech can be re-posted
 
 #define BOUNCE_IMPULSE 0x0C0  // Increased slightly for more "pop"
 #define PUSH_OUT_10_6  0x060  
 #define REBOUND_STUN   4 
 
-void update_player(Car *p) {
+void update_player(void) {
 
     if (state_timer > 300) {
         // Optional: reset velocity here to ensure they don't creep
-        p->vel_x = 0;
-        p->vel_y = 0;
+        CAR_SET16(car_vx, PLAYER_SLOT, 0);
+        CAR_SET16(car_vy, PLAYER_SLOT, 0);
         return;
     }
 
-    if (is_action_pressed(0, ACTION_RESCUE) && rescue_cooldown == 0) {
-        rescue_player(p);
+    if (is_action_just_pressed(0, ACTION_RESCUE) && rescue_cooldown == 0) {
+        rescue_player();
         rescue_cooldown = 120; // Prevent reuse for 2 seconds
     }
     if (rescue_cooldown > 0) rescue_cooldown--;
 
+    // Work on locals; written back to the slot arrays at the end
+    uint16_t x = CAR_POS(car_x, PLAYER_SLOT);
+    uint16_t y = CAR_POS(car_y, PLAYER_SLOT);
+    int16_t vel_x = CAR_GET16(car_vx, PLAYER_SLOT);
+    int16_t vel_y = CAR_GET16(car_vy, PLAYER_SLOT);
+    uint8_t angle = car_angle[PLAYER_SLOT];
+
     // --- 1. HANDLE ROTATION ---
-    if (is_action_pressed(0, ACTION_ROTATE_LEFT)) p->angle += TURN_SPEED;
-    if (is_action_pressed(0, ACTION_ROTATE_RIGHT)) p->angle -= TURN_SPEED;
+    if (slick_timer == 0) {
+        if (is_action_down(0, ACTION_ROTATE_LEFT)) angle += TURN_SPEED;
+        if (is_action_down(0, ACTION_ROTATE_RIGHT)) angle -= TURN_SPEED;
+    }
+    car_angle[PLAYER_SLOT] = angle;
 
-    int8_t s = SIN_LUT[p->angle];
-    int8_t c = SIN_LUT[(p->angle + 64) & 0xFF];
+    int8_t s = SIN_LUT[angle];
+    int8_t c = SIN_LUT[(angle + 64) & 0xFF];
 
     // --- 2. THE ROTATION EJECTOR (No Stun) ---
     // If rotating pushed a corner into a wall, shove out immediately.
     // This prevents "getting stuck" while turning near a wall.
-    int16_t test_x = p->x >> 6;
-    int16_t test_y = p->y >> 6;
+    int16_t test_x = x >> 6;
+    int16_t test_y = y >> 6;
 
     if (is_colliding_fast(test_x, test_y)) {
         // Smart Ejector: Try Backward first, then Forward
         // s/c are ~2 pixels magnitude in 10.6 (127 ~= 2 * 64)
         
-        int16_t back_x = p->x + (int16_t)s; 
-        int16_t back_y = p->y + (int16_t)c;
+        uint16_t back_x = x + (int16_t)s; 
+        uint16_t back_y = y + (int16_t)c;
         
         if (!is_colliding_fast(back_x >> 6, back_y >> 6)) {
-            p->x = back_x;
-            p->y = back_y;
+            x = back_x;
+            y = back_y;
         } else {
             // Backend blocked? Try pushing blocked nose out (Forward)
-            int16_t fwd_x = p->x - (int16_t)s;
-            int16_t fwd_y = p->y - (int16_t)c;
+            uint16_t fwd_x = x - (int16_t)s;
+            uint16_t fwd_y = y - (int16_t)c;
             
             if (!is_colliding_fast(fwd_x >> 6, fwd_y >> 6)) {
-                p->x = fwd_x;
-                p->y = fwd_y;
+                x = fwd_x;
+                y = fwd_y;
             }
         }
     }
@@ -217,111 +229,170 @@ void update_player(Car *p) {
     // A. Calculate current power tier
     uint8_t current_thrust_shift = THRUST_SCALER;
 
-    if (p->drs_active_timer > 0) {
+    if (drs_active_timer > 0) {
         current_thrust_shift = THRUST_SCALER - 1; // Boosted power
-        p->drs_active_timer--; // CRUCIAL: Count down the boost time every frame!
+        drs_active_timer--; // CRUCIAL: Count down the boost time every frame!
     }
 
-    if (rebound_timer > 0) {
-        rebound_timer--;
+    if (car_rebound[PLAYER_SLOT] > 0) {
+        car_rebound[PLAYER_SLOT]--;
     } else {
         // B. Main Throttle (This now automatically uses DRS if active)
-        if (is_action_pressed(0, ACTION_FIRE)) {
-            p->vel_x -= (int16_t)s >> current_thrust_shift;
-            p->vel_y -= (int16_t)c >> current_thrust_shift;
+        if (is_action_down(0, ACTION_FIRE)) {
+            vel_x -= (int16_t)s >> current_thrust_shift;
+            vel_y -= (int16_t)c >> current_thrust_shift;
         }
 
         // C. Reverse Thrust
-        if (is_action_pressed(0, ACTION_SUPER_FIRE)) {
-            p->vel_x += (int16_t)s >> (THRUST_SCALER + 1);
-            p->vel_y += (int16_t)c >> (THRUST_SCALER + 1);
+        if (is_action_down(0, ACTION_SUPER_FIRE)) {
+            vel_x += (int16_t)s >> (THRUST_SCALER + 1);
+            vel_y += (int16_t)c >> (THRUST_SCALER + 1);
         }
 
         // D. DRS Activation Trigger
         // If charged and not currently boosting, check for the button press
-        if (p->drs_charge >= DRS_MAX_CHARGE && p->drs_active_timer == 0) {
-            if (is_action_pressed(0, ACTION_ALT_FIRE)) {
-                p->drs_charge = 0;           // Consume the charge immediately
-                p->drs_active_timer = 120;   // Set boost for 2 seconds (120 frames)
-                // play_psg_boost_sfx();
+        if (drs_charge >= DRS_MAX_CHARGE && drs_active_timer == 0) {
+            if (is_action_just_pressed(0, ACTION_ALT_FIRE)) {
+                drs_charge = 0;           // Consume the charge immediately
+                drs_active_timer = 120;   // Set boost for 2 seconds (120 frames)
+                sound_post(SND_BOOST, 0);
+                particle_spawn(PART_SMOKE, (CAR_POS(car_x, PLAYER_SLOT) >> 6) + 8,
+                               (CAR_POS(car_y, PLAYER_SLOT) >> 6) + 8, 4);
             }
         }
     }
 
-    int16_t dvx = (p->vel_x >> FRICTION_SHIFT);
-    int16_t dvy = (p->vel_y >> FRICTION_SHIFT);
-    if (dvx == 0 && p->vel_x != 0) dvx = (p->vel_x > 0) ? 1 : -1;
-    if (dvy == 0 && p->vel_y != 0) dvy = (p->vel_y > 0) ? 1 : -1;
-    p->vel_x -= dvx; p->vel_y -= dvy;
+    if (slick_timer > 0) {
+        slick_timer--; // On oil: no friction either
+    } else {
+        int16_t dvx = (vel_x >> FRICTION_SHIFT);
+        int16_t dvy = (vel_y >> FRICTION_SHIFT);
+        if (dvx == 0 && vel_x != 0) dvx = (vel_x > 0) ? 1 : -1;
+        if (dvy == 0 && vel_y != 0) dvy = (vel_y > 0) ? 1 : -1;
+        vel_x -= dvx; vel_y -= dvy;
+    }
 
     // --- 4. INDEPENDENT AXIS BOUNCE (The "Fun" Logic) ---
-    int16_t cur_px_x = p->x >> 6;
-    int16_t cur_px_y = p->y >> 6;
+    bool hit_wall = false;
+    int16_t cur_px_x = x >> 6;
+    int16_t cur_px_y = y >> 6;
 
     // TRY X MOVEMENT
-    if (p->vel_x != 0) {
-        uint16_t next_x = p->x + (p->vel_x >> 2);
+    if (vel_x != 0) {
+        uint16_t next_x = x + (vel_x >> 2);
         if (is_colliding_fast(next_x >> 6, cur_px_y)) {
             // BOUNCE X
-            p->vel_x = (p->vel_x > 0) ? -BOUNCE_IMPULSE : BOUNCE_IMPULSE;
-            p->x += (p->vel_x > 0 ? PUSH_OUT_10_6 : -PUSH_OUT_10_6);
-            rebound_timer = REBOUND_STUN;
+            vel_x = (vel_x > 0) ? -BOUNCE_IMPULSE : BOUNCE_IMPULSE;
+            x += (vel_x > 0 ? PUSH_OUT_10_6 : -PUSH_OUT_10_6);
+            car_rebound[PLAYER_SLOT] = REBOUND_STUN;
+            hit_wall = true;
             // Note: We don't update cur_px_x so Y-check is clean
         } else {
-            p->x = next_x;
-            cur_px_x = p->x >> 6;
+            x = next_x;
+            cur_px_x = x >> 6;
         }
     }
 
     // TRY Y MOVEMENT
-    if (p->vel_y != 0) {
-        uint16_t next_y = p->y + (p->vel_y >> 2);
+    if (vel_y != 0) {
+        uint16_t next_y = y + (vel_y >> 2);
         if (is_colliding_fast(cur_px_x, next_y >> 6)) {
             // BOUNCE Y
-            p->vel_y = (p->vel_y > 0) ? -BOUNCE_IMPULSE : BOUNCE_IMPULSE;
-            p->y += (p->vel_y > 0 ? PUSH_OUT_10_6 : -PUSH_OUT_10_6);
-            rebound_timer = REBOUND_STUN;
+            vel_y = (vel_y > 0) ? -BOUNCE_IMPULSE : BOUNCE_IMPULSE;
+            y += (vel_y > 0 ? PUSH_OUT_10_6 : -PUSH_OUT_10_6);
+            car_rebound[PLAYER_SLOT] = REBOUND_STUN;
+            hit_wall = true;
         } else {
-            p->y = next_y;
+            y = next_y;
         }
     }
 
     // --- 5. TERRAIN & AUDIO ---
-    uint16_t px = (p->x >> 6) + 8;
-    uint16_t py = (p->y >> 6) + 8;
-    uint8_t ttype = get_terrain_at(px, py);
+    uint16_t px = (x >> 6) + 8;
+    uint16_t py = (y >> 6) + 8;
+    uint8_t surface = get_terrain_at(px, py);
+    uint8_t ttype = TERRAIN_TYPE(surface);
 
     if (ttype == TERRAIN_GRASS) {
         // Standard Grass: 12.5% drag
-        p->vel_x -= (p->vel_x >> 3);
-        p->vel_y -= (p->vel_y >> 3);
+        vel_x -= (vel_x >> 3);
+        vel_y -= (vel_y >> 3);
     } 
     else if (ttype == TERRAIN_WALL) {
         // "Sticky" Wall: 50% drag
-        p->vel_x -= (p->vel_x >> 1);
-        p->vel_y -= (p->vel_y >> 1);
+        vel_x -= (vel_x >> 1);
+        vel_y -= (vel_y >> 1);
         
         // HARD CAP: Ensure the car can never go faster than a "crawl" inside a wall
         // 0x40 is 1.0 pixel. Let's cap at 0.5 pixels (0x20)
-        if (p->vel_x > 0x20)  p->vel_x = 0x20;
-        if (p->vel_x < -0x20) p->vel_x = -0x20;
-        if (p->vel_y > 0x20)  p->vel_y = 0x20;
-        if (p->vel_y < -0x20) p->vel_y = -0x20;
+        if (vel_x > 0x20)  vel_x = 0x20;
+        if (vel_x < -0x20) vel_x = -0x20;
+        if (vel_y > 0x20)  vel_y = 0x20;
+        if (vel_y < -0x20) vel_y = -0x20;
+    }
+
+    // --- 6. TRIGGERS (from the same probe) ---
+    uint8_t trigger = TERRAIN_TRIGGER(surface);
+    if (trigger != last_trigger) {
+        last_trigger = trigger;
+        switch (trigger) {
+            case TRIGGER_BOOST:
+                vel_x -= (int16_t)s >> BOOST_PAD_SHIFT;
+                vel_y -= (int16_t)c >> BOOST_PAD_SHIFT;
+                if (drs_active_timer < BOOST_PAD_FRAMES) drs_active_timer = BOOST_PAD_FRAMES;
+                sound_post(SND_BOOST, 0);
+                particle_spawn(PART_SMOKE, px, py, 2);
+                break;
+            case TRIGGER_OIL:
+                slick_timer = OIL_SLICK_FRAMES;
+                sound_post(SND_SCREECH, 0);
+                break;
+            case TRIGGER_PICKUP:
+                drs_charge = DRS_MAX_CHARGE;
+                sound_post(SND_BEEP, 0);
+                break;
+        }
+    }
+
+    uint16_t speed = abs(vel_x) + abs(vel_y);
+    update_engine_sound(speed);
+
+    if (hit_wall) {
+        sound_post(SND_WALL, 0);
+        particle_spawn(PART_SPARK, (x >> 6) + 8, (y >> 6) + 8, 3);
+    }
+    if (ttype == TERRAIN_GRASS && speed > GRASS_DUST_SPEED && (RIA.vsync & 3) == 0) {
+        particle_spawn(PART_DUST, (x >> 6) + 8, (y >> 6) + 8, 1);
+    }
+
+    // Tyres squeal when turning hard at speed (re-posted as the effect ends)
+    if (skid_cooldown > 0) skid_cooldown--;
+    bool turning = is_action_down(0, ACTION_ROTATE_LEFT) || is_action_down(0, ACTION_ROTATE_RIGHT);
+    if (turning && speed > SKID_SPEED && ttype != TERRAIN_GRASS) {
+        if (skid_cooldown == 0) {
+            sound_post(SND_SCREECH, 0);
+            skid_cooldown = SKID_SFX_FRAMES;
+        }
+        if ((RIA.vsync & 3) == 0) particle_spawn(PART_SMOKE, (x >> 6) + 8, (y >> 6) + 8, 1);
     }
-    update_engine_sound((uint16_t)(abs(p->vel_x) + abs(p->vel_y)));
 
     // Clamping
-    if (p->x < 0x200) p->x = 0x200;
-    if (p->x > 32768 - 0x200) p->x = 32768 - 0x200;
-    if (p->y < 0x200) p->y = 0x200;
-    if (p->y > 24576 - 0x200) p->y = 24576 - 0x200;
+    if (x < WORLD_MIN_10_6) x = WORLD_MIN_10_6;
+    if (x > world_max_x) x = world_max_x;
+    if (y < WORLD_MIN_10_6) y = WORLD_MIN_10_6;
+    if (y > world_max_y) y = world_max_y;
+
+    CAR_SET16(car_x, PLAYER_SLOT, x);
+    CAR_SET16(car_y, PLAYER_SLOT, y);
+    CAR_SET16(car_vx, PLAYER_SLOT, vel_x);
+    CAR_SET16(car_vy, PLAYER_SLOT, vel_y);
 }
 
 
 
 // OPTIMIZED: Direct XRAM writes with correct layout
-void draw_player(Car *p, int16_t screen_x, int16_t screen_y) {
-    uint8_t ang = p->angle;
+void draw_player(int16_t screen_x, int16_t screen_y) {
+    uint8_t ang = car_angle[PLAYER_SLOT];
     int16_t s = (int16_t)SIN_LUT[ang] << 1;
     int16_t c = (int16_t)SIN_LUT[(ang + 64) & 0xFF] << 1;
     int16_t tx = TX_LUT[ang];
@@ -342,139 +413,129 @@ void draw_player(Car *p, int16_t screen_x, int16_t screen_y) {
 
 }
 
-void update_camera(Car *p) {
-    int16_t car_px_x = p->x >> 6;
-    int16_t car_px_y = p->y >> 6;
+void update_camera(void) {
+    int16_t car_px_x = CAR_POS(car_x, PLAYER_SLOT) >> 6;
+    int16_t car_px_y = CAR_POS(car_y, PLAYER_SLOT) >> 6;
     int16_t target_x = 160 - car_px_x;
     int16_t target_y = 120 - car_px_y;
+    int16_t min_x = SCREEN_WIDTH - (int16_t)world_w_px;
+    int16_t min_y = SCREEN_HEIGHT - (int16_t)world_h_px;
 
     if (target_x > 0) target_x = 0;
-    if (target_x < -192) target_x = -192;
+    if (target_x < min_x) target_x = min_x;
     if (target_y > 0) target_y = 0;
-    if (target_y < -144) target_y = -144;
+    if (target_y < min_y) target_y = min_y;
 
     extern int16_t next_scroll_x, next_scroll_y;
     next_scroll_x = target_x;
     next_scroll_y = target_y;
 }
 
-void update_lap_logic(Car *p, bool is_player) {
-    uint16_t total = g_num_active_waypoints;
-    if (total == 0) return;
+void update_lap_logic(uint8_t slot) {
+    if (g_num_gates == 0) return;
+    if (car_next_checkpoint[slot] >= g_num_gates) car_next_checkpoint[slot] = 0;
 
-    // State Machine based on Waypoint Progress
-    switch (p->next_checkpoint) {
-        case 1: // Looking for CP1 (25% progress)
-            if (p->current_waypoint >= (total / 4) && p->current_waypoint > 0) {
-                p->next_checkpoint = 2;
-            }
-            break;
+    // Only the gate we're waiting for is tested: O(1) per car, no terrain lookups
+    const TrackGate *g = &track_gates[car_next_checkpoint[slot]];
+    int16_t cx = (CAR_POS(car_x, slot) >> 6) + 8;
+    int16_t cy = (CAR_POS(car_y, slot) >> 6) + 8;
 
-        case 2: // Looking for CP2 (50% progress)
-            if (p->current_waypoint >= (total / 2)) {
-                p->next_checkpoint = 3;
-            }
-            break;
+    // Away from the gate: forget which side we were on
+    if (cx < g->min_x || cx > g->max_x || cy < g->min_y || cy > g->max_y) {
+        car_gate_side[slot] = 0;
+        return;
+    }
 
-        case 3: // Looking for CP3 -> Finish Ready (75% Progress)
-            if (p->current_waypoint >= (total * 3 / 4)) {
-                 p->next_checkpoint = 0; // Armed for Finish
-            }
-            break;
-
-        case 0: // Finish Line (Armed)
-            {
-                // SUPERSAMPLING: Check multiple points along velocity vector
-                bool crossed_line = false;
-                int16_t cur_x = p->x;
-                int16_t cur_y = p->y;
-                int16_t vel_x = p->vel_x;
-                int16_t vel_y = p->vel_y;
-
-                for (int i = 0; i <= 4; i++) {
-                     int16_t sample_x = cur_x - ((vel_x * i) >> 2);
-                     int16_t sample_y = cur_y - ((vel_y * i) >> 2);
-                     uint16_t cx = (sample_x >> 6) + 8;
-                     uint16_t cy = (sample_y >> 6) + 8;
-                     
-                     if (get_terrain_at(cx, cy) == TERRAIN_FINISH) {
-                         crossed_line = true;
-                         break;
-                     }
-                }
-
-                // ALTERNATIVE TRIGGER: Removed by request.
-                // We rely 100% on Supersampled Tile Detection (TERRAIN_FINISH)
-                // for both Player and AI.
-
-                if (crossed_line) {
-                    p->laps++;
-                    p->next_checkpoint = 1; // Loop back to CP1
-                    
-                    // Reset Waypoint to 1
-                    p->current_waypoint = 1; 
-
-                    // DEBUG: Print Lap Completion with Identity
-                    const char* who = (is_player) ? "Player" : "AI";
-                    printf("%s Completed Lap %d\n", who, p->laps); 
-                }
-            }
-            break;
+    // Which side of the segment are we on? (small values inside the box, fits int16)
+    int16_t side = (g->x2 - g->x1) * (cy - g->y1) - (g->y2 - g->y1) * (cx - g->x1);
+
+    if (side < 0) {
+        car_gate_side[slot] = -1;
+        return;
+    }
+
+    // Sign change from behind to past the gate = crossing.
+    // Cars move < GATE_MARGIN px per frame, so DRS speeds can't tunnel through.
+    if (car_gate_side[slot] >= 0) {
+        car_gate_side[slot] = 1; // Entered the box already past the gate
+        return;
     }
+    car_gate_side[slot] = 1;
+
+    if (car_next_checkpoint[slot] != 0) {
+        // Checkpoint gate: look for the next one (finish line after the last)
+        car_next_checkpoint[slot]++;
+        if (car_next_checkpoint[slot] >= g_num_gates) car_next_checkpoint[slot] = 0;
+        return;
+    }
+
+    // Finish line (Armed)
+    car_laps[slot]++;
+    car_next_checkpoint[slot] = (g_num_gates > 1) ? 1 : 0; // Loop back to CP1
+    
+    // Reset Waypoint to 1
+    car_waypoint[slot] = 1; 
+
+    if (slot == PLAYER_SLOT) sound_post(SND_LAP, car_laps[slot]);
+
+    log_event(LOG_LAP, slot, car_laps[slot], 0);
 }
 
 void update_player_progress(void) {
-    int16_t px = (car.x >> 6) + 8;
-    int16_t py = (car.y >> 6) + 8;
+    int16_t px = (CAR_POS(car_x, PLAYER_SLOT) >> 6) + 8;
+    int16_t py = (CAR_POS(car_y, PLAYER_SLOT) >> 6) + 8;
+    uint8_t wp = car_waypoint[PLAYER_SLOT];
 
-    int16_t dx = abs(waypoints[car.current_waypoint].x - px);
-    int16_t dy = abs(waypoints[car.current_waypoint].y - py);
+    int16_t dx = abs(waypoints[wp].x - px);
+    int16_t dy = abs(waypoints[wp].y - py);
     
     // Large 64px radius for the human player
     if (dx <80 && dy < 80) {
-        car.progress_steps++; // This never resets!
-        car.current_waypoint++;
-        if (car.current_waypoint >= g_num_active_waypoints) {
-             car.current_waypoint = 0;
+        wp++;
+        if (wp >= g_num_active_waypoints) {
+             wp = 0;
         }
+        car_waypoint[PLAYER_SLOT] = wp;
     }
 }
 
-void update_drs_system(Car *p) {
+void update_drs_system(void) {
     // 1. Logic for Active Boost
-    if (p->drs_active_timer > 0) {
-        p->drs_active_timer--;
+    if (drs_active_timer > 0) {
+        drs_active_timer--;
         return; // Charge is frozen while boosting
     }
 
     // 2. Charging Logic (Only if NOT leading)
     if (!is_player_leading()) {
-        if (p->drs_charge < DRS_MAX_CHARGE) {
-            p->drs_charge++;
+        if (drs_charge < DRS_MAX_CHARGE) {
+            drs_charge++;
         }
     }
 
     // 3. Activation
-    if (p->drs_charge >= DRS_MAX_CHARGE) {
-        if (is_action_pressed(0, ACTION_SUPER_FIRE)) {
-            p->drs_charge = 0;
-            p->drs_active_timer = DRS_BOOST_TIME;
-            // play_psg_drs_sound(); 
+    if (drs_charge >= DRS_MAX_CHARGE) {
+        if (is_action_just_pressed(0, ACTION_SUPER_FIRE)) {
+            drs_charge = 0;
+            drs_active_timer = DRS_BOOST_TIME;
+            sound_post(SND_DRS, 0);
+            particle_spawn(PART_SMOKE, (CAR_POS(car_x, PLAYER_SLOT) >> 6) + 8,
+                           (CAR_POS(car_y, PLAYER_SLOT) >> 6) + 8, 4);
         }
     }
 }
 
-void hud_draw_drs(Car *p) {
+void hud_draw_drs(void) {
     // 13 bytes: 12 for "[----------]" + 1 for the null terminator \0
     char bar[] = "[----------]"; 
-    uint8_t segments = (p->drs_charge / 30); // 300 / 30 = 10 segments
+    uint8_t segments = (drs_charge / 30); // 300 / 30 = 10 segments
     uint8_t color = HUD_COL_RED;
 
-    if (p->drs_active_timer > 0) {
+    if (drs_active_timer > 0) {
         // Boost is active! Show remaining time (120 / 12 = 10 segments)
-        segments = (p->drs_active_timer / 12); 
+        segments = (drs_active_timer / 12); 
         color = HUD_COL_YELLOW;
-    } else if (p->drs_charge >= DRS_MAX_CHARGE) {
+    } else if (drs_charge >= DRS_MAX_CHARGE) {
         segments = 10;
         color = (RIA.vsync & 0x08) ? HUD_COL_CYAN : HUD_COL_WHITE;
     }
@@ -487,4 +548,4 @@ void hud_draw_drs(Car *p) {
 
     hud_print(1, 1, "DRS:", HUD_COL_WHITE, HUD_COL_BG);
     hud_print(5, 1, bar, color, HUD_COL_BG);
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #define PLAYER_H
 
 #include <stdbool.h>
+#include "cars.h"
 
 // DRS System Constants
 #define DRS_MAX_CHARGE 300    // 5 seconds
@@ -11,26 +12,21 @@
 #define THRUST_SCALER  3  // Tuning: how fast the car accelerates
 #define TURN_SPEED     4  // How many angle units to turn per frame
 
-typedef struct {
-    int16_t x;         // Position X (24.8 Fixed Point)
-    int16_t y;         // Position Y (24.8 Fixed Point)
-    int16_t vel_x;     // Velocity X (8.8 Fixed Point)
-    int16_t vel_y;     // Velocity Y (8.8 Fixed Point)
-    uint8_t angle;     // 0-255 (0=Up/North)
-    // --- Lap System ---
-    uint8_t laps;            // Count of completed laps
-    uint8_t next_checkpoint; // 0=Finish, 1=CP1, 2=CP2, 3=CP3
-    uint8_t current_waypoint;  // For tracking progress
-    uint16_t total_progress; // Track progress for AI comparison
-    uint16_t progress_steps;  // INCREMENTS ONLY: 0, 1, 2, 3, 4, 5... 60...
-    // --- DRS System ---
-    uint16_t drs_charge;      // 0 to 300 (5 seconds at 60Hz)
-    uint8_t drs_active_timer; // Countdown while boosting
-} Car;
+#define SKID_SPEED      320 // |vx|+|vy| (10.6) above which hard turns screech
+#define SKID_SFX_FRAMES 12  // Length of the screech effect
+#define GRASS_DUST_SPEED 128 // Above this, grass kicks up dust
+
+// Trigger tiles (see TRIGGER_* in track.h)
+#define BOOST_PAD_SHIFT  1   // Kick of SIN_LUT >> shift along the heading
+#define BOOST_PAD_FRAMES 30  // Boosted thrust after a pad
+#define OIL_SLICK_FRAMES 40  // No grip or steering after an oil patch
+
+// Player DRS state (the player is car slot PLAYER_SLOT)
+extern uint16_t drs_charge;      // 0 to 300 (5 seconds at 60Hz)
+extern uint8_t drs_active_timer; // Countdown while boosting
 
 extern uint8_t startX;
 extern uint8_t startY;
-extern Car car;
 
 // This table maps 0-255 (angle) to -127 to 127 (signed fraction)
 extern const int8_t SIN_LUT[256];
@@ -38,13 +34,13 @@ extern const int16_t TX_LUT[256];
 extern const int16_t TY_LUT[256];
 
 extern void init_player(void);
-extern void update_player(Car *p);
-extern void draw_player(Car *p, int16_t screen_x, int16_t screen_y);
-extern void update_camera(Car *p);
-extern void update_lap_logic(Car *p, bool is_player);
+extern void update_player(void);
+extern void draw_player(int16_t screen_x, int16_t screen_y);
+extern void update_camera(void);
+extern void update_lap_logic(uint8_t slot);
 extern uint8_t is_colliding_fast(int16_t px, int16_t py);
 extern void update_player_progress(void);
-extern void update_drs_system(Car *p);
-extern void hud_draw_drs(Car *p);
+extern void update_drs_system(void);
+extern void hud_draw_drs(void);
 
 #endif // PLAYER_H
\ No newline at end of file
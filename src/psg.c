@@ -0,0 +1,191 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "psg.h"
+#include "constants.h"
+
+// Channel register offsets
+#define PSG_FREQ_LO      0
+#define PSG_FREQ_HI      1
+#define PSG_DUTY         2
+#define PSG_VOL_ATTACK   3 // Attenuation << 4 | attack
+#define PSG_VOL_DECAY    4 // Attenuation << 4 | decay
+#define PSG_WAVE_RELEASE 5 // Waveform << 4 | release
+#define PSG_PAN_GATE     6 // Pan << 1 | gate
+#define PSG_REGS         7 // Last byte is unused
+
+#define WAVE_SINE     0x00
+#define WAVE_SQUARE   0x10
+#define WAVE_SAWTOOTH 0x20
+#define WAVE_TRIANGLE 0x30
+#define WAVE_NOISE    0x40
+
+// PSG frequency units are 1/3 Hz
+#define HZ(f) ((uint16_t)((f) * 3))
+
+typedef struct {
+    uint16_t freq;
+    uint8_t vol;    // Attenuation: 0 loudest, 15 silent
+    uint8_t frames; // 0 ends the effect
+} SfxStep;
+
+typedef struct {
+    const SfxStep *steps;
+    uint8_t wave_release;
+    uint8_t duty;
+    uint8_t priority; // Higher steals lower
+} SfxDef;
+
+static const SfxStep screech_steps[] = {
+    {HZ(1900), 6, 2}, {HZ(2150), 5, 2}, {HZ(1950), 6, 2},
+    {HZ(2200), 6, 2}, {HZ(2000), 8, 2}, {HZ(2050), 11, 2}, {0, 15, 0}
+};
+static const SfxStep wall_steps[] = {
+    {HZ(180), 0, 2}, {HZ(120), 3, 3}, {HZ(90), 7, 4}, {HZ(70), 11, 4}, {0, 15, 0}
+};
+static const SfxStep car_hit_steps[] = {
+    {HZ(420), 1, 2}, {HZ(260), 4, 3}, {HZ(150), 8, 4}, {0, 15, 0}
+};
+static const SfxStep boost_steps[] = {
+    {HZ(300), 4, 2}, {HZ(400), 4, 2}, {HZ(520), 4, 2}, {HZ(660), 5, 3}, {HZ(800), 8, 3}, {0, 15, 0}
+};
+static const SfxStep drs_steps[] = {
+    {HZ(200), 3, 4}, {HZ(260), 3, 4}, {HZ(340), 3, 4}, {HZ(440), 3, 4},
+    {HZ(570), 4, 4}, {HZ(740), 5, 6}, {HZ(960), 8, 6}, {0, 15, 0}
+};
+static const SfxStep beep_steps[] = {
+    {HZ(880), 3, 10}, {0, 15, 0}
+};
+static const SfxStep go_steps[] = {
+    {HZ(1760), 2, 24}, {HZ(1760), 6, 6}, {0, 15, 0}
+};
+static const SfxStep lap_steps[] = {
+    {HZ(1047), 3, 5}, {HZ(1319), 3, 5}, {HZ(1568), 3, 10}, {0, 15, 0}
+};
+
+static const SfxDef sfx_defs[SFX_COUNT] = {
+    [SFX_SCREECH]  = {screech_steps, WAVE_SAWTOOTH | 1, 0x80, 1},
+    [SFX_WALL_HIT] = {wall_steps,    WAVE_NOISE | 2,    0x80, 3},
+    [SFX_CAR_HIT]  = {car_hit_steps, WAVE_NOISE | 2,    0x80, 3},
+    [SFX_BOOST]    = {boost_steps,   WAVE_SQUARE | 1,   0x40, 4},
+    [SFX_DRS]      = {drs_steps,     WAVE_SAWTOOTH | 2, 0x80, 4},
+    [SFX_BEEP]     = {beep_steps,    WAVE_SQUARE | 1,   0x80, 5},
+    [SFX_GO]       = {go_steps,      WAVE_SQUARE | 2,   0x80, 5},
+    [SFX_LAP]      = {lap_steps,     WAVE_TRIANGLE | 2, 0x80, 5},
+};
+
+typedef struct {
+    const SfxStep *step; // NULL = free (gate already off)
+    uint8_t sfx;
+    uint8_t timer;       // Frames left on this step
+    uint8_t started;     // play_clock stamp, for stealing the oldest
+    bool restart;        // Retrigger: gate low for an update first if it was on
+} Voice;
+
+static Voice voices[PSG_SFX_VOICES];
+static uint8_t play_clock = 0;
+
+// What the PSG registers currently hold
+static uint8_t shadow[PSG_SFX_VOICES][PSG_REGS];
+
+static void psg_set(uint8_t v, uint8_t reg, uint8_t value) {
+    if (shadow[v][reg] == value) return;
+    shadow[v][reg] = value;
+    RIA.addr1 = PSG_XRAM_ADDR + v * PSG_CHANNEL_SIZE + reg;
+    RIA.rw1 = value;
+}
+
+void init_psg(void) {
+    // Clear all 8 channels, then point the PSG at them
+    RIA.addr1 = PSG_XRAM_ADDR;
+    RIA.step1 = 1;
+    for (uint8_t i = 0; i < PSG_CHANNELS * PSG_CHANNEL_SIZE; i++) {
+        RIA.rw1 = 0;
+    }
+    xregn(0, 1, 0x00, 1, PSG_XRAM_ADDR);
+
+    for (uint8_t v = 0; v < PSG_SFX_VOICES; v++) {
+        voices[v].step = NULL;
+        for (uint8_t r = 0; r < PSG_REGS; r++) shadow[v][r] = 0;
+    }
+    RIA.step1 = 0; // psg_set() addresses each register itself
+}
+
+void psg_play(uint8_t sfx) {
+    if (sfx >= SFX_COUNT) return;
+    const SfxDef *def = &sfx_defs[sfx];
+    int8_t pick = -1;
+
+    // Already playing: restart it rather than stacking copies
+    for (uint8_t v = 0; v < PSG_SFX_VOICES; v++) {
+        if (voices[v].step && voices[v].sfx == sfx) { pick = v; break; }
+    }
+    if (pick < 0) {
+        for (uint8_t v = 0; v < PSG_SFX_VOICES; v++) {
+            if (!voices[v].step) { pick = v; break; }
+        }
+    }
+    if (pick < 0) {
+        // Steal the oldest voice that isn't more important
+        uint8_t oldest = 0;
+        for (uint8_t v = 0; v < PSG_SFX_VOICES; v++) {
+            if (sfx_defs[voices[v].sfx].priority > def->priority) continue;
+            uint8_t age = play_clock - voices[v].started;
+            if (pick < 0 || age > oldest) { pick = v; oldest = age; }
+        }
+    }
+    if (pick < 0) return; // Everything playing outranks it
+
+    Voice *vc = &voices[pick];
+    vc->step = def->steps;
+    vc->sfx = sfx;
+    vc->timer = def->steps[0].frames;
+    vc->started = play_clock++;
+    vc->restart = true;
+}
+
+void psg_update(void) {
+    for (uint8_t v = 0; v < PSG_SFX_VOICES; v++) {
+        Voice *vc = &voices[v];
+        if (!vc->step) continue;
+
+        if (vc->restart) {
+            // A voice still gated on gets one update with the gate low, so
+            // the PSG sees the edge and restarts the envelope
+            if (shadow[v][PSG_PAN_GATE] & 0x01) {
+                psg_set(v, PSG_PAN_GATE, 0);
+                continue;
+            }
+            const SfxDef *def = &sfx_defs[vc->sfx];
+            psg_set(v, PSG_WAVE_RELEASE, def->wave_release);
+            psg_set(v, PSG_DUTY, def->duty);
+            vc->restart = false;
+        }
+
+        const SfxStep *st = vc->step;
+        uint8_t vol = st->vol << 4; // Attack/decay 0: the table is the envelope
+        psg_set(v, PSG_FREQ_LO, st->freq & 0xFF);
+        psg_set(v, PSG_FREQ_HI, st->freq >> 8);
+        psg_set(v, PSG_VOL_ATTACK, vol);
+        psg_set(v, PSG_VOL_DECAY, vol);
+        psg_set(v, PSG_PAN_GATE, 0x01); // Centre, gate on
+
+        if (--vc->timer == 0) {
+            vc->step++;
+            if (vc->step->frames == 0) {
+                psg_set(v, PSG_PAN_GATE, 0); // Release
+                vc->step = NULL;
+            } else {
+                vc->timer = vc->step->frames;
+            }
+        }
+    }
+}
+
+void psg_stop_all(void) {
+    for (uint8_t v = 0; v < PSG_SFX_VOICES; v++) {
+        voices[v].step = NULL;
+        psg_set(v, PSG_PAN_GATE, 0);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef PSG_H
+#define PSG_H
+
+#include <stdint.h>
+
+// RIA PSG sound effects.
+//
+// Effects are short frequency/volume envelope tables played on a few PSG
+// channels. A new effect takes a free voice, restarts itself if already
+// playing, or steals the oldest voice of equal or lower priority.
+// psg_update() runs once per vsync (from the audio IRQ) and only writes the
+// PSG registers whose value changed, so its cost is bounded by the voice
+// count no matter how many effects are posted.
+
+#define PSG_CHANNELS     8
+#define PSG_CHANNEL_SIZE 8  // Bytes per channel in XRAM
+#define PSG_SFX_VOICES   4  // Channels 0-3
+
+typedef enum {
+    SFX_SCREECH,
+    SFX_WALL_HIT,
+    SFX_CAR_HIT,
+    SFX_BOOST,
+    SFX_DRS,
+    SFX_BEEP,     // Countdown 3, 2, 1
+    SFX_GO,
+    SFX_LAP,
+    SFX_COUNT
+} SfxId;
+
+extern void init_psg(void); // Before audio_start()
+
+// Vsync IRQ only (see audio.h)
+extern void psg_play(uint8_t sfx);
+extern void psg_update(void);
+extern void psg_stop_all(void);
+
+#endif // PSG_H
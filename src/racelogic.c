@@ -3,10 +3,14 @@
 #include <stdio.h>
 #include <rp6502.h>
 #include "racelogic.h"
+#include "particles.h"
+#include "colliders.h"
 #include "hud.h"
 #include "player.h"
 #include "ai.h"
 #include "track.h" // Added for load_track
+#include "audio.h"
+#include "pacing.h"
 
 
 uint8_t race_minutes = 0;
@@ -21,10 +25,16 @@ bool countdown_active = false;
 void update_race_logic(void) {
     if (state_timer > 0) {
         state_timer--;
+
+        // Countdown beeps as the 3, 2, 1 appear
+        if (state_timer == COUNTDOWN_TOTAL_TIME - 1 || state_timer == 420 || state_timer == 360) {
+            sound_post(SND_BEEP, 0);
+        }
         
         // Trigger the start of the race at the "GO!" mark (300)
         if (state_timer == 300) {
             current_state = STATE_RACING;
+            sound_post(SND_GO, 0);
             // Clear the "Prepare" message area if necessary
             hud_print(16, 15, "          ", 0, 0); 
         }
@@ -34,7 +44,9 @@ void update_race_logic(void) {
 void reset_race(void) {
     load_track(current_track_id);
     init_player(); // Resets car x,y, angle, laps, checkpoints
-    init_ai();     // Resets all 3 AI cars to grid
+    init_ai();     // Resets all AI cars to grid
+    particles_clear();
+    colliders_clear();
     
     // Clear HUD
     for (uint8_t y=0; y<MESSAGE_HEIGHT; y++) {
@@ -47,23 +59,24 @@ void reset_race(void) {
 
     race_winner = 0xFF;
 
-    init_player();
-    car.laps = 0;
-    car.current_waypoint = 1; // Looking for the first corner
-    car.progress_steps = 1;   
-    car.next_checkpoint = 1;  // IMPORTANT: Looking for Checkpoint 1 (Gate logic)
-    
+    init_player(); // reset_car() clears laps, waypoint and gate state
     init_ai();
-    for (int i=0; i<3; i++) {
-        ai_cars[i].car.laps = 0;
-        ai_cars[i].car.current_waypoint = 1;
-        ai_cars[i].car.progress_steps = 1;
-        ai_cars[i].car.next_checkpoint = 1; // AI must hit CP gates too
-        ai_cars[i].base_speed_shift = 5;    // Start at Normal/Slow speed
-        ai_cars[i].rebound_timer = 0;
-        ai_cars[i].stuck_timer = 0;
+    for (uint8_t i = FIRST_AI_SLOT; i < NUM_CARS; i++) {
+        ai_base_speed_shift[i] = 5;    // Start at Normal/Slow speed
+        ai_stuck_timer[i] = 0;
     }
 
+    reset_race_progress(); // Seed progress from the grid positions
+
+    // Camera on the grid; a large track's window is filled before the first frame
+    update_camera();
+    extern int16_t next_scroll_x, next_scroll_y;
+    track_stream_sync(-next_scroll_x, -next_scroll_y);
+    terrain_cache_misses = 0;
+    terrain_cache_fills = 0;
+    track_chunks_forced = 0;
+    pacing_reset(); // Histogram covers this race only
+
     // ... car resets ...
     race_minutes = 0;
     race_seconds = 0;
@@ -110,11 +123,58 @@ void update_race_timer(void) {
     }
 }
 
-bool is_player_leading(void) {
-    for (int i = 0; i < NUM_AI_CARS; i++) {
-        if (ai_cars[i].car.progress_steps > car.progress_steps) {
-            return false; // Someone is further ahead than the player
+// --- RACE ORDER ---
+// Each car samples the progress field once per frame. The sample wraps at
+// track_lap_length, so the frame-to-frame delta is unwrapped into a
+// monotonic race_progress that keeps counting across laps.
+
+uint8_t race_order[NUM_CARS];
+uint8_t player_position = 1;
+
+static uint16_t sample_progress(uint8_t slot) {
+    return get_progress_at((CAR_POS(car_x, slot) >> 6) + 8, (CAR_POS(car_y, slot) >> 6) + 8);
+}
+
+void reset_race_progress(void) {
+    for (uint8_t slot = 0; slot < NUM_CARS; slot++) {
+        car_lap_progress[slot] = sample_progress(slot);
+        car_race_progress[slot] = 0;
+        race_order[slot] = slot;
+    }
+    player_position = 1;
+}
+
+void update_race_progress(void) {
+    int16_t half_lap = track_lap_length >> 1;
+
+    // 1. One table read per car
+    for (uint8_t slot = 0; slot < NUM_CARS; slot++) {
+        uint16_t sample = sample_progress(slot);
+        int16_t delta = (int16_t)(sample - car_lap_progress[slot]);
+
+        if (delta > half_lap) delta -= track_lap_length;       // Backed over the line
+        else if (delta < -half_lap) delta += track_lap_length; // Crossed the line
+
+        car_race_progress[slot] += delta;
+        car_lap_progress[slot] = sample;
+    }
+
+    // 2. Incremental sort: one bubble pass per frame.
+    // Overtakes are rare, so the order is almost always already sorted.
+    for (uint8_t i = 0; i < NUM_CARS - 1; i++) {
+        uint8_t a = race_order[i];
+        uint8_t b = race_order[i + 1];
+        if (car_race_progress[b] > car_race_progress[a]) {
+            race_order[i] = b;
+            race_order[i + 1] = a;
         }
     }
-    return true;
+
+    for (uint8_t i = 0; i < NUM_CARS; i++) {
+        if (race_order[i] == PLAYER_SLOT) player_position = i + 1;
+    }
+}
+
+bool is_player_leading(void) {
+    return race_order[0] == PLAYER_SLOT;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "cars.h"
 
 #define COUNTDOWN_TOTAL_TIME 480 // 4 seconds at 120 FPS
 
@@ -20,6 +21,11 @@ extern void reset_race(void);
 extern void update_race_timer(void);
 extern void hud_draw_timer(void);
 extern bool is_player_leading(void);
+extern void reset_race_progress(void);
+extern void update_race_progress(void);
+
+extern uint8_t race_order[NUM_CARS];   // Car slots, leader first
+extern uint8_t player_position;        // 1 = leading
 
 extern GameState current_state;
 extern uint16_t state_timer;
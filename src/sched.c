@@ -0,0 +1,157 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "sched.h"
+#include "assets.h"
+#include "log.h"
+
+// Time since vsync comes from VIA timer 1 in free-run mode, restarted at
+// 0xFFFF by the vsync IRQ. Only the high byte is read (reading the low byte
+// would clear the underflow flag), so time is in 256-cycle units. The flag
+// is set at every underflow (each 256 units); frame_elapsed() counts and
+// clears it, so the range covers a whole frame (~520 units). A wrap is only
+// missed if nothing reads the timer for 256 units (~8 ms).
+#define FRAME_UNITS       SCHED_FRAME_UNITS
+#define IRQ_RESERVE_UNITS SCHED_IRQ_RESERVE_UNITS
+#define VIA_T1_FLAG       0x40
+
+Task sched_tasks[SCHED_MAX_TASKS];
+uint8_t sched_num_tasks = 0;
+static uint8_t next_task = 0; // Round robin start
+uint16_t sched_busy = 0;      // Units spent in steps during the last sched_idle()
+
+static volatile uint8_t frame_gen = 0; // Bumped by the vsync IRQ
+static uint8_t wraps_gen = 0;           // Frame the count below belongs to
+static uint8_t frame_wraps = 0;         // Underflows seen since the vsync
+
+static uint16_t frame_elapsed(void) {
+    uint8_t gen = frame_gen;
+    if (gen != wraps_gen) {
+        wraps_gen = gen;
+        frame_wraps = 0;
+    }
+    uint8_t hi = VIA.t1_hi;
+    if (VIA.ifr & VIA_T1_FLAG) {
+        VIA.ifr = VIA_T1_FLAG; // Writing the bit clears it
+        frame_wraps++;
+        hi = VIA.t1_hi;        // It may have underflowed after the first read
+    }
+    if (gen != frame_gen) return 0; // The vsync IRQ restarted the timer meanwhile
+    return ((uint16_t)frame_wraps << 8) + (uint8_t)(0xFF - hi);
+}
+
+uint16_t sched_frame_elapsed(void) {
+    return frame_elapsed();
+}
+
+uint16_t sched_frame_left(void) {
+    uint16_t now = frame_elapsed();
+    return (now + IRQ_RESERVE_UNITS < FRAME_UNITS) ? FRAME_UNITS - IRQ_RESERVE_UNITS - now : 0;
+}
+
+void sched_frame_start(void) {
+    frame_gen++;
+    VIA.t1_hi = 0xFF; // Reload from the latch, clear the flag
+}
+
+void sched_init(void) {
+    VIA.ier = VIA_T1_FLAG;   // Bit 7 clear: disable the T1 interrupt
+    VIA.acr = (VIA.acr & 0x3F) | 0x40; // T1 free-run, no PB7 output
+    VIA.t1_latch_lo = 0xFF;
+    VIA.t1_latch_hi = 0xFF;
+    sched_frame_start();
+    sched_num_tasks = 0;
+}
+
+int8_t sched_add(const char* name, TaskFn fn, uint16_t cost, uint8_t max_skip) {
+    if (sched_num_tasks >= SCHED_MAX_TASKS) {
+        log_event(LOG_SCHED_FULL, SCHED_MAX_TASKS, cost, 0);
+        return -1;
+    }
+    Task *t = &sched_tasks[sched_num_tasks];
+    t->name = name;
+    t->fn = fn;
+    t->cost = cost;
+    t->max_skip = max_skip;
+    t->pt = 0;
+    t->active = true;
+    t->skipped = 0;
+    t->steps = 0;
+    t->cycles = 0;
+    t->worst = 0;
+    t->forced = 0;
+    t->over = 0;
+    return sched_num_tasks++;
+}
+
+void sched_wake(int8_t id) {
+    if (id >= 0 && id < sched_num_tasks) sched_tasks[id].active = true;
+}
+
+static void run_step(Task* t) {
+    uint16_t t0 = frame_elapsed();
+    if (t->fn(&t->pt) == TASK_DONE) t->active = false;
+    uint16_t t1 = frame_elapsed();
+
+    uint16_t units = (t1 >= t0) ? t1 - t0 : 0xFF; // Backwards: the vsync restarted the timer
+    uint16_t used = (units < 0xFF) ? units << 8 : 0xFFFF;
+    sched_busy += units;
+    t->steps++;
+    t->cycles += used;
+    if (used > t->worst) t->worst = used;
+    if (used > t->cost) t->over++;
+    t->skipped = 0;
+}
+
+void sched_idle(uint8_t vsync_last) {
+    uint8_t ran = 0; // Bit per task stepped this frame
+    sched_busy = 0;
+
+    // Starved tasks first: they run whether or not there's slack
+    for (uint8_t i = 0; i < sched_num_tasks; i++) {
+        Task *t = &sched_tasks[i];
+        if (t->active && t->skipped >= t->max_skip) {
+            t->forced++;
+            run_step(t);
+            ran |= 1 << i;
+        }
+    }
+
+    uint16_t last = 0;
+    while (RIA.vsync == vsync_last) {
+        uint16_t now = frame_elapsed();
+        if (now < last || now + IRQ_RESERVE_UNITS >= FRAME_UNITS) continue; // Out of slack: just wait
+        last = now;
+        uint16_t slack = (uint16_t)(FRAME_UNITS - IRQ_RESERVE_UNITS - now) << 8;
+
+        // Next task (round robin) that hasn't run this frame and fits
+        Task *pick = NULL;
+        for (uint8_t n = 0; n < sched_num_tasks; n++) {
+            uint8_t i = (next_task + n) % sched_num_tasks;
+            Task *t = &sched_tasks[i];
+            if (!t->active || (ran & (1 << i)) || t->cost > slack) continue;
+            pick = t;
+            ran |= 1 << i;
+            next_task = i + 1;
+            break;
+        }
+        if (!pick) continue;
+        run_step(pick);
+    }
+
+    for (uint8_t i = 0; i < sched_num_tasks; i++) {
+        Task *t = &sched_tasks[i];
+        if (t->active && !(ran & (1 << i)) && t->skipped < 0xFF) t->skipped++;
+    }
+}
+
+void sched_log_stats(void) {
+    for (uint8_t i = 0; i < sched_num_tasks; i++) {
+        Task *t = &sched_tasks[i];
+        uint16_t name = asset_name_hash(t->name);
+        uint16_t avg = t->steps ? (uint16_t)(t->cycles / t->steps) : 0;
+        log_event(LOG_TASK_STEPS, name, t->steps, avg);
+        log_event(LOG_TASK_WORST, name, t->worst, t->cost);
+        log_event(LOG_TASK_LATE, name, t->forced, t->over);
+    }
+}
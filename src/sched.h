@@ -0,0 +1,79 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Cooperative idle-time scheduler.
+//
+// The main loop used to busy-wait for the next vsync. sched_idle() spends
+// that slack running background tasks instead, one step per task per frame,
+// and only starts a step if its declared cost still fits before the vsync.
+// A task that hasn't had a step for max_skip frames runs anyway, so heavy
+// frames delay background work but never starve it.
+//
+// Tasks are protothreads: a function that keeps its place in a pt_t and
+// returns TASK_YIELD to continue next frame or TASK_DONE to go idle until
+// sched_wake(). Locals don't survive a yield; keep state in statics.
+
+#define SCHED_MAX_TASKS 8
+
+#define TASK_YIELD 0
+#define TASK_DONE  1
+
+typedef uint16_t pt_t;
+typedef uint8_t (*TaskFn)(pt_t* pt);
+
+#define PT_BEGIN(pt) switch (*(pt)) { case 0:
+#define PT_YIELD(pt) do { *(pt) = __LINE__; return TASK_YIELD; case __LINE__:; } while (0)
+#define PT_END(pt)   } *(pt) = 0; return TASK_DONE
+
+typedef struct {
+    const char *name;
+    TaskFn fn;
+    uint16_t cost;     // Declared worst case for one step (cycles)
+    uint8_t max_skip;  // Frames a step can be put off before it's forced
+    pt_t pt;
+    bool active;
+    uint8_t skipped;   // Frames since its last step
+
+    // Accounting (256-cycle resolution)
+    uint16_t steps;
+    uint32_t cycles;
+    uint16_t worst;
+    uint16_t forced;   // Steps run with no slack left (starved too long)
+    uint16_t over;     // Steps that took longer than cost
+} Task;
+
+extern Task sched_tasks[SCHED_MAX_TASKS];
+extern uint8_t sched_num_tasks;
+
+extern void sched_init(void);
+// Returns the task id, or -1 if the table is full
+extern int8_t sched_add(const char* name, TaskFn fn, uint16_t cost, uint8_t max_skip);
+extern void sched_wake(int8_t id);
+
+// Run background steps until RIA.vsync moves past vsync_last
+extern void sched_idle(uint8_t vsync_last);
+
+// Frame time left before the vsync IRQ's reserve, in 256-cycle units
+// (0 when there is none). For foreground work that scales with slack.
+#define SCHED_UNIT_CYCLES 256
+#define SCHED_FRAME_UNITS (uint16_t)(8000000UL / 60 / SCHED_UNIT_CYCLES) // 8 MHz PHI2
+#define SCHED_IRQ_RESERVE_UNITS 16 // Kept free for the audio IRQ and the loop top
+#define SCHED_UNITS(cycles) (uint16_t)(((cycles) + SCHED_UNIT_CYCLES - 1) / SCHED_UNIT_CYCLES)
+extern uint16_t sched_frame_left(void);
+
+// Frame time used since the vsync, same units
+extern uint16_t sched_frame_elapsed(void);
+
+// Units taken by task steps in the last sched_idle(), forced ones included
+extern uint16_t sched_busy;
+
+// Vsync IRQ: restart the frame timer
+extern void sched_frame_start(void);
+
+// Three log records per task: steps and average, worst case, forced runs and overruns
+extern void sched_log_stats(void);
+
+#endif // SCHED_H
@@ -0,0 +1,134 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "opl.h"
+#include "instruments.h"
+#include "xram.h"
+#include "assets.h"
+
+// Plays SongEvent streams through OPL_SetPatch / OPL_SetVolume / OPL_NoteOn.
+// The song sits in XRAM and the IRQ reads one event at a time through
+// portal 1 (the IRQ's portal), so playback needs no file I/O and no RAM
+// buffer. Patches and volumes are only uploaded when they change.
+
+#define SONG_MAX_SIZE        0x2000 // When the manifest doesn't know the file
+#define SONG_EVENTS_PER_TICK 16     // Bounds the IRQ's cost on dense chords
+#define NO_PATCH             0xFF
+
+static volatile bool song_active = false; // Set last by main, read by the IRQ
+static uint16_t song_addr = XRAM_NULL;
+static uint16_t song_events = 0;
+static uint16_t song_idx;
+static uint16_t song_ms;       // Elapsed since the last event played
+static uint8_t song_ms_frac;   // Thirds of a millisecond
+static bool song_fetch;        // next_event needs reading
+static SongEvent next_event;
+
+static uint8_t channel_patch[9];
+static uint8_t channel_velocity[9];
+
+static void read_event(uint16_t idx, SongEvent* ev) {
+    RIA.addr1 = song_addr + idx * sizeof(SongEvent);
+    RIA.step1 = 1;
+    uint8_t *dst = (uint8_t*)ev;
+    for (uint8_t i = 0; i < sizeof(SongEvent); i++) {
+        dst[i] = RIA.rw1;
+    }
+}
+
+static void set_patch(uint8_t ch, uint8_t program) {
+    if (channel_patch[ch] == program) return; // Lazy: already loaded
+
+    const OPL_Patch *p;
+    switch (program) {
+        case SONG_DRUM_BD:    p = &drum_bd; break;
+        case SONG_DRUM_SNARE: p = &drum_snare; break;
+        case SONG_DRUM_HIHAT: p = &drum_hihat; break;
+        default:              p = &gm_bank[program & 0x7F]; break;
+    }
+    OPL_SetPatch(ch, p);
+    channel_is_drum[ch] = (program >= SONG_DRUM_BD);
+    channel_patch[ch] = program;
+    channel_velocity[ch] = 0xFF; // The patch rewrote the carrier level
+}
+
+static void play_event(const SongEvent* ev) {
+    uint8_t ch = ev->channel;
+    if (ch > 8) return;
+
+    switch (ev->type) {
+        case SONG_NOTE_ON:
+            if (channel_velocity[ch] != ev->velocity) {
+                OPL_SetVolume(ch, ev->velocity);
+                channel_velocity[ch] = ev->velocity;
+            }
+            OPL_NoteOn(ch, ev->note);
+            break;
+
+        case SONG_NOTE_OFF:
+            OPL_NoteOff(ch);
+            break;
+
+        case SONG_PATCH:
+            set_patch(ch, ev->note);
+            break;
+    }
+}
+
+void song_play(const char* filename) {
+    song_stop();
+
+    uint16_t size = asset_size(filename);
+    if (size == 0) size = SONG_MAX_SIZE;
+    song_addr = xram_load(filename, size);
+    if (song_addr == XRAM_NULL) return;
+
+    song_events = size / sizeof(SongEvent);
+    song_idx = 0;
+    song_ms = 0;
+    song_ms_frac = 0;
+    song_fetch = true;
+    for (uint8_t ch = 0; ch < 9; ch++) {
+        channel_patch[ch] = NO_PATCH;
+        channel_velocity[ch] = 0xFF;
+    }
+
+    song_active = true;
+}
+
+void song_stop(void) {
+    if (!song_active) return;
+    song_active = false;
+    music_silence_pending = true;
+    xram_release(song_addr); // The song stays cached for the next play
+    song_addr = XRAM_NULL;
+}
+
+// Vsync IRQ: one 60Hz tick (16.67 ms)
+void update_song(void) {
+    if (!song_active) return;
+
+    song_ms += 16;
+    song_ms_frac += 2;
+    if (song_ms_frac >= 3) {
+        song_ms_frac -= 3;
+        song_ms++;
+    }
+
+    for (uint8_t n = 0; n < SONG_EVENTS_PER_TICK; n++) {
+        if (song_fetch) {
+            read_event(song_idx, &next_event);
+            song_fetch = false;
+        }
+        if (next_event.delay_ms > song_ms) return;
+        song_ms -= next_event.delay_ms;
+
+        if (next_event.type == SONG_END) {
+            song_idx = 0;
+        } else {
+            play_event(&next_event);
+            if (++song_idx >= song_events) song_idx = 0;
+        }
+        song_fetch = true;
+    }
+}
@@ -1,61 +1,231 @@
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include "sound.h"
+#include "audio.h"
 #include "opl.h"
+#include "psg.h"
+#include "voices.h"
 
-// Channel 8 specific offsets
-#define CH8_MOD_OFF 0x12
-#define CH8_CAR_OFF 0x15
-#define CH8_FREQ_LO 0xA8
-#define CH8_FREQ_HI 0xB8
-#define CH8_FEEDBACK 0xC8
+// The engine borrows an OPL channel from the voice manager while it runs
+// (first SND_ENGINE to SND_ENGINE_STOP), so the music has all nine
+// channels outside a race.
+static uint8_t engine_ch = VOICE_NONE;
+
+static bool engine_on = false;
+static uint16_t engine_fnum = 150;     // Latest target from SND_ENGINE
+static uint16_t written_fnum = 0xFFFF; // Last pitch sent to the chip
 
 void init_opl2_engine_sound(void) {
-    // 1. Setup the "Grit" (Modulator - Op 18)
-    opl_write(0x20 + CH8_MOD_OFF, 0x01); // Multiplier 1
-    opl_write(0x40 + CH8_MOD_OFF, 0x2F); // Volume (some attenuation for grit)
-    opl_write(0x60 + CH8_MOD_OFF, 0xF0); // Instant Attack
-    opl_write(0x80 + CH8_MOD_OFF, 0xFF); // Max Sustain
-    opl_write(0xE0 + CH8_MOD_OFF, 0x00); // Sine
-
-    // 2. Setup the "Body" (Carrier - Op 21)
-    opl_write(0x20 + CH8_CAR_OFF, 0x01); // Multiplier 1
-    opl_write(0x40 + CH8_CAR_OFF, 0x00); // Max Volume
-    opl_write(0x60 + CH8_CAR_OFF, 0xF0); // Instant Attack
-    opl_write(0x80 + CH8_CAR_OFF, 0xFF); // Max Sustain
-    opl_write(0xE0 + CH8_CAR_OFF, 0x00); // Sine
+    engine_ch = VOICE_NONE;
+    engine_on = false;
+    written_fnum = 0xFFFF;
+}
+
+// --- IRQ side (called from audio.c only) ---
+
+static void engine_start(void) {
+    engine_ch = opl_voice_claim(VOICE_PRIO_ENGINE);
+    if (engine_ch == VOICE_NONE) return;
+
+    uint8_t mod = opl_mod_offsets[engine_ch];
+    uint8_t car = opl_car_offsets[engine_ch];
+
+    // 1. Setup the "Grit" (Modulator)
+    opl_write(0x20 + mod, 0x01); // Multiplier 1
+    opl_write(0x40 + mod, 0x2F); // Volume (some attenuation for grit)
+    opl_write(0x60 + mod, 0xF0); // Instant Attack
+    opl_write(0x80 + mod, 0xFF); // Max Sustain
+    opl_write(0xE0 + mod, 0x00); // Sine
+
+    // 2. Setup the "Body" (Carrier)
+    opl_write(0x20 + car, 0x01); // Multiplier 1
+    opl_write(0x40 + car, 0x00); // Max Volume
+    opl_write(0x60 + car, 0xF0); // Instant Attack
+    opl_write(0x80 + car, 0xFF); // Max Sustain
+    opl_write(0xE0 + car, 0x00); // Sine
 
     // 3. Feedback (0x0E = Feedback 7, FM Connection)
     // Feedback 7 is what creates the "rough" engine growl.
-    opl_write(CH8_FEEDBACK, 0x0E); 
-
-    // 4. Initial Key On at Octave 1
-    // 0x20 = Key On, 0x04 = Block 1
-    opl_write(CH8_FREQ_HI, 0x24); 
+    opl_write(0xC0 + engine_ch, 0x0E); 
+    written_fnum = 0xFFFF; // Key on with the first pitch write
 }
 
-void update_engine_sound(uint16_t velocity_mag) {
-    // Normalize velocity (assuming 10.6 or 8.8) to a useful OPL F-Number
-    // Low speed -> F-Number 150
-    // High speed -> F-Number ~500
-    uint16_t f_number = 150 + (velocity_mag << 1);
-
+static void write_engine_pitch(uint16_t f_number) {
     if (f_number > 1023) f_number = 1023;
+    if (f_number == written_fnum || engine_ch == VOICE_NONE) return;
+    written_fnum = f_number;
 
     // Write frequency
-    opl_write(CH8_FREQ_LO, (uint8_t)(f_number & 0xFF));
+    opl_write(0xA0 + engine_ch, (uint8_t)(f_number & 0xFF));
     
     // Write Block/Key (Maintaining Octave 1 + Key-On)
     // We use a low octave (Block 1) to get that deep displacement hum
     uint8_t b8_val = 0x20 | (1 << 2) | (uint8_t)(f_number >> 8);
-    opl_write(CH8_FREQ_HI, b8_val);
+    opl_write(0xB0 + engine_ch, b8_val);
     
     // Important: Update your shadow register so opl_silence_all doesn't
-    // get confused if it ever tries to read back Channel 8's state
-    shadow_b0[8] = b8_val & 0x1F;
+    // get confused if it ever tries to read back the engine channel's state
+    shadow_b0[engine_ch] = b8_val & 0x1F;
+}
+
+// --- FM one-shots ---
+// Crashes and boosts borrow an OPL channel for their length and hand it
+// back after the release tail; the voice manager then restores the music
+// patch that lived there. Crashes may take a channel from the music,
+// boosts only use a spare one. With no channel, the PSG plays the effect.
+
+#define FM_TAIL_FRAMES 10 // After key off, before the channel goes back
+
+typedef struct {
+    uint16_t fnum;  // F-number | block << 10 (0 ends the effect)
+    uint8_t frames;
+} FmStep;
+
+typedef struct {
+    uint8_t mod[5];     // 0x20, 0x40, 0x60, 0x80, 0xE0
+    uint8_t car[5];
+    uint8_t feedback;   // 0xC0
+    uint8_t priority;   // VOICE_PRIO_*
+    const FmStep *steps;
+} FmSfx;
+
+#define FM_NOTE(fnum, block) ((fnum) | ((uint16_t)(block) << 10))
+
+static const FmStep crash_steps[] = {
+    {FM_NOTE(0x160, 2), 3}, {FM_NOTE(0x100, 1), 4}, {FM_NOTE(0x0C0, 1), 6}, {0, 0}
+};
+static const FmStep boost_steps[] = {
+    {FM_NOTE(0x150, 4), 2}, {FM_NOTE(0x190, 4), 2}, {FM_NOTE(0x1D0, 4), 2},
+    {FM_NOTE(0x220, 4), 3}, {FM_NOTE(0x280, 4), 3}, {0, 0}
+};
+
+static const FmSfx fm_crash = {
+    {0x0C, 0x00, 0xF4, 0x2F, 0x00}, // Mult 12, full mod depth: noisy
+    {0x01, 0x00, 0xF3, 0x2F, 0x00},
+    0x0E, VOICE_PRIO_CRASH, crash_steps
+};
+static const FmSfx fm_boost = {
+    {0x21, 0x18, 0xF2, 0x05, 0x00},
+    {0x21, 0x00, 0xF2, 0x06, 0x00},
+    0x08, VOICE_PRIO_AMBIENT, boost_steps
+};
+
+static const uint8_t op_regs[5] = {0x20, 0x40, 0x60, 0x80, 0xE0};
+
+static const FmSfx *fm_sfx = NULL; // Playing, or NULL
+static const FmStep *fm_step;
+static uint8_t fm_ch = VOICE_NONE;
+static uint8_t fm_timer;
+
+static void fm_release(void) {
+    if (fm_ch != VOICE_NONE) opl_voice_release(fm_ch); // Keys it off too
+    fm_ch = VOICE_NONE;
+    fm_sfx = NULL;
 }
 
+static void fm_key(uint16_t note) {
+    opl_write(0xA0 + fm_ch, note & 0xFF);
+    opl_write(0xB0 + fm_ch, 0x20 | (note >> 8));
+    shadow_b0[fm_ch] = (note >> 8) & 0x1F;
+}
+
+// psg_sfx plays instead when there's no channel for it
+static void fm_play(const FmSfx *sfx, uint8_t psg_sfx) {
+    // Something more important keeps its channel
+    if (fm_sfx && fm_sfx->priority > sfx->priority) {
+        psg_play(psg_sfx);
+        return;
+    }
+    fm_release();
+
+    fm_ch = opl_voice_claim(sfx->priority);
+    if (fm_ch == VOICE_NONE) {
+        psg_play(psg_sfx);
+        return;
+    }
+    uint8_t mod = opl_mod_offsets[fm_ch];
+    uint8_t car = opl_car_offsets[fm_ch];
+    for (uint8_t i = 0; i < sizeof(op_regs); i++) {
+        opl_write(op_regs[i] + mod, sfx->mod[i]);
+        opl_write(op_regs[i] + car, sfx->car[i]);
+    }
+    opl_write(0xC0 + fm_ch, sfx->feedback);
+
+    fm_sfx = sfx;
+    fm_step = sfx->steps;
+    fm_timer = fm_step->frames;
+    fm_key(fm_step->fnum);
+}
+
+static void fm_tick(void) {
+    if (!fm_sfx || --fm_timer) return;
+    if (!fm_step->frames) { // Tail done
+        fm_release();
+        return;
+    }
+    fm_step++;
+    if (fm_step->frames) {
+        fm_timer = fm_step->frames;
+        fm_key(fm_step->fnum);
+    } else {
+        opl_write(0xB0 + fm_ch, shadow_b0[fm_ch]); // Key off, let it ring out
+        fm_timer = FM_TAIL_FRAMES;
+    }
+}
+
+// One-shot events -> PSG effect, indexed from SND_CRASH
+static const uint8_t event_sfx[] = {
+    SFX_CAR_HIT, SFX_DRS, SFX_LAP, SFX_SCREECH, SFX_WALL_HIT, SFX_BOOST, SFX_BEEP, SFX_GO
+};
+
+void sound_apply(uint8_t type, uint16_t param) {
+    switch (type) {
+        case SND_ENGINE:
+            // Normalize velocity (assuming 10.6 or 8.8) to a useful OPL F-Number
+            // Low speed -> F-Number 150
+            // High speed -> F-Number ~500
+            if (engine_ch == VOICE_NONE) engine_start();
+            engine_fnum = 150 + (param << 1);
+            engine_on = true;
+            break;
+
+        case SND_ENGINE_STOP:
+            // Key off and give the channel back to the music
+            engine_on = false;
+            written_fnum = 0xFFFF;
+            if (engine_ch != VOICE_NONE) opl_voice_release(engine_ch);
+            engine_ch = VOICE_NONE;
+            break;
+
+        case SND_CRASH:
+        case SND_WALL:
+            fm_play(&fm_crash, event_sfx[type - SND_CRASH]);
+            break;
+
+        case SND_BOOST:
+            fm_play(&fm_boost, SFX_BOOST);
+            break;
+
+        default:
+            if ((uint8_t)(type - SND_CRASH) < sizeof(event_sfx)) psg_play(event_sfx[type - SND_CRASH]);
+            break;
+    }
+}
+
+// Once per vsync, after the queue has been drained
+void sound_tick(void) {
+    if (engine_on) write_engine_pitch(engine_fnum);
+    fm_tick();
+    psg_update();
+}
+
+// --- Game side ---
+
+void update_engine_sound(uint16_t velocity_mag) {
+    sound_post(SND_ENGINE, velocity_mag);
+}
 
 void stop_engine_sound(void) {
-    // Clear the Key-On bit in 0xB8
-    opl_write(0xB8, 0x00);
-}
\ No newline at end of file
+    sound_post(SND_ENGINE_STOP, 0);
+}
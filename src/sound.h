@@ -5,5 +5,9 @@ extern void init_opl2_engine_sound(void);
 extern void update_engine_sound(uint16_t velocity_mag);
 extern void stop_engine_sound(void);
 
+// Vsync IRQ only (see audio.h)
+extern void sound_apply(uint8_t type, uint16_t param);
+extern void sound_tick(void);
+
 
 #endif // SOUND_H
\ No newline at end of file
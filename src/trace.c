@@ -0,0 +1,78 @@
+#ifdef ENABLE_TRACE
+
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "trace.h"
+#include "sched.h"
+#include "xram.h"
+#include "constants.h"
+#include "log.h"
+#include "usb_hid_keys.h"
+
+#define EVENT_BYTES 4
+#define DUMP_KEY    KEY_F9
+
+static uint16_t ring_xram = XRAM_NULL;
+static uint16_t ring_pos = 0;     // Byte offset of the next event
+static bool ring_wrapped = false;
+static uint16_t stop_after = 0;   // Events left before freezing (0: not stopping)
+static bool frozen = false;
+static bool key_was_down = false;
+
+void trace_init(void) {
+    ring_xram = xram_alloc("trace ring", TRACE_RING_BYTES);
+}
+
+void trace_event(uint8_t id) {
+    if (frozen || ring_xram == XRAM_NULL) return;
+
+    uint16_t t = sched_frame_elapsed();
+    RIA.addr0 = ring_xram + ring_pos;
+    RIA.step0 = 1;
+    RIA.rw0 = id;
+    RIA.rw0 = RIA.vsync;
+    RIA.rw0 = t & 0xFF;
+    RIA.rw0 = t >> 8;
+
+    ring_pos = (ring_pos + EVENT_BYTES) & (TRACE_RING_BYTES - 1);
+    if (ring_pos == 0) ring_wrapped = true;
+    if (stop_after && --stop_after == 0) frozen = true;
+}
+
+void trace_drop(void) {
+    trace_event(TR_DROP | TRACE_MARK_BIT);
+    if (!stop_after) stop_after = TRACE_AFTER_DROP;
+}
+
+// Oldest event first: from the write position to the end, then the start
+static void trace_dump(void) {
+    int fd = open(TRACE_FILE, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0) {
+        log_event(LOG_TRACE_ERROR, 0, 0, 0);
+        return;
+    }
+
+    static const uint8_t header[6] = {'R', 'T', 'R', 'C', TRACE_VERSION, EVENT_BYTES};
+    write(fd, header, sizeof(header));
+    if (ring_wrapped) write_xram(ring_xram + ring_pos, TRACE_RING_BYTES - ring_pos, fd);
+    if (ring_pos) write_xram(ring_xram, ring_pos, fd);
+    close(fd);
+
+    log_event(LOG_TRACE_DUMPED, (ring_wrapped ? TRACE_RING_BYTES : ring_pos) / EVENT_BYTES, 0, 0);
+    ring_pos = 0;
+    ring_wrapped = false;
+    stop_after = 0;
+    frozen = false;
+}
+
+void trace_poll(void) {
+    RIA.addr0 = KEYBOARD_INPUT + (DUMP_KEY >> 3);
+    bool down = (RIA.rw0 & (1 << (DUMP_KEY & 7))) != 0;
+    if (down && !key_was_down) trace_dump();
+    key_was_down = down;
+}
+
+#endif // ENABLE_TRACE
@@ -0,0 +1,64 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Event trace for timeline views of bad frames (cmake -DENABLE_TRACE=ON).
+//
+// TRACE_BEGIN/TRACE_END bracket a stage with 4-byte events (id, vsync,
+// frame timer in 256-cycle units) written through portal 0 into a ring in
+// XRAM, so they cost a few port writes and no RAM. When the pacing monitor
+// sees a dropped frame the ring records TRACE_AFTER_DROP more events and
+// freezes, keeping the bad frame and what led up to it. F9 writes the ring
+// to TRACE_FILE and re-arms it; tools/trace_to_json.py turns the file into
+// Chrome about:tracing / Perfetto JSON.
+//
+// Without ENABLE_TRACE every macro compiles to nothing. Main loop only, and
+// never between setting RIA.addr0 and the port accesses that use it.
+
+#define TRACE_FILE       "trace.bin"
+#define TRACE_RING_BYTES 0x2000 // 2048 events; power of two
+#define TRACE_AFTER_DROP 256    // Events kept after a dropped frame
+#define TRACE_VERSION    1
+
+#define TRACE_END_BIT  0x80
+#define TRACE_MARK_BIT 0x40 // Instant event (no duration)
+
+// X(id, "name"). Append only: ids are file format.
+#define TRACE_STAGES(X) \
+    X(TR_SYNC,       "sync") \
+    X(TR_VIDEO,      "video") \
+    X(TR_INPUT,      "input") \
+    X(TR_LOGIC,      "logic") \
+    X(TR_PLAYER,     "player") \
+    X(TR_AI,         "ai") \
+    X(TR_COLLIDE,    "collide") \
+    X(TR_DRAW,       "draw") \
+    X(TR_TRACK_LOAD, "track load") \
+    X(TR_MAP_STREAM, "map stream") \
+    X(TR_DROP,       "dropped frame")
+
+#define TRACE_ENUM(id, name) id,
+enum { TRACE_STAGES(TRACE_ENUM) TRACE_STAGE_COUNT };
+#undef TRACE_ENUM
+
+#ifdef ENABLE_TRACE
+extern void trace_init(void);
+extern void trace_event(uint8_t id);
+extern void trace_drop(void);
+extern void trace_poll(void);
+
+#define TRACE_INIT()    trace_init()
+#define TRACE_BEGIN(id) trace_event(id)
+#define TRACE_END(id)   trace_event((id) | TRACE_END_BIT)
+#define TRACE_DROP()    trace_drop()
+#define TRACE_POLL()    trace_poll() // F9: dump
+#else
+#define TRACE_INIT()
+#define TRACE_BEGIN(id)
+#define TRACE_END(id)
+#define TRACE_DROP()
+#define TRACE_POLL()
+#endif
+
+#endif // TRACE_H
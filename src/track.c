@@ -6,81 +6,328 @@
 #include <unistd.h>
 #include "track.h"
 #include "constants.h"
+#include "xram.h"
+#include "assets.h"
+#include "colliders.h"
+#include "log.h"
+#include "trace.h"
 
-uint8_t world_map[3072];
-uint8_t tile_properties[256];
+uint8_t tile_properties[TRACK_MAX_TILE_IDS];
 
 // Collision masks: 8 rows per tile, 8 bits per row
 // Bit 7 (0x80) = leftmost pixel, Bit 0 (0x01) = rightmost pixel
 // 1 = solid/wall, 0 = passable
-uint8_t tile_collision_masks[256][8];
+uint8_t tile_collision_masks[TRACK_MAX_TILE_IDS][8];
 
-// Helper to load file directly to XRAM
-void load_file_to_xram(const char* filename, uint16_t dest_addr, uint16_t max_size) {
+// Helper to load file directly to RAM
+bool load_file_to_ram(const char* filename, void* dest, uint16_t max_size) {
     int fd = open(filename, O_RDONLY);
     if (fd < 0) {
-        printf("Error opening %s\n", filename);
-        return;
+        log_event(LOG_OPEN_ERROR, asset_name_hash(filename), 0, 0);
+        return false;
     }
     
-    // We can't read directly to XRAM with standard read(), 
-    // so we read to a small buffer and write to XRAM via RIA
-    uint8_t buffer[128];
-    uint16_t total_read = 0;
+    int bytes = read(fd, dest, max_size);
+    if (bytes <= 0) log_event(LOG_READ_ERROR, asset_name_hash(filename), 0, 0);
+    else log_event(LOG_RAM_LOAD, asset_name_hash(filename), bytes, 0);
     
-    RIA.addr0 = dest_addr;
-    RIA.step0 = 1;
-
-    while (total_read < max_size) {
-        int bytes = read(fd, buffer, sizeof(buffer));
-        if (bytes <= 0) break;
-        
-        for (int i = 0; i < bytes; i++) {
-            RIA.rw0 = buffer[i];
+    close(fd);
+    return bytes > 0;
+}
+
+// XRAM copies of the current track (held while it's the active track)
+uint16_t track_map_xram = XRAM_NULL;
+uint16_t track_tiles_xram = XRAM_NULL;
+
+typedef struct {
+    uint8_t w_tiles, h_tiles; // Map size
+    uint8_t banks;            // 256-tile banks in tiles.bin
+} TrackLayout;
+
+// Per track (index = track id - 1), measured from the track files at build time
+static const TrackLayout track_layouts[NUM_TRACKS] = {
+    TRACK_LAYOUTS
+};
+
+uint8_t track_w_tiles = TRACK_MAP_WIDTH_TILES;
+uint8_t track_h_tiles = TRACK_MAP_HEIGHT_TILES;
+uint16_t world_w_px = TRACK_MAP_WIDTH_TILES * 8;
+uint16_t world_h_px = TRACK_MAP_HEIGHT_TILES * 8;
+uint16_t world_max_x = (uint16_t)(TRACK_MAP_WIDTH_TILES * 8 - 8) << 6;
+uint16_t world_max_y = (uint16_t)(TRACK_MAP_HEIGHT_TILES * 8 - 8) << 6;
+bool track_streaming = false;
+bool track_banked = false;
+
+uint8_t progress_cell_shift = PROGRESS_MIN_CELL_SHIFT;
+uint8_t progress_field_width = (TRACK_MAP_WIDTH_TILES * 8) >> PROGRESS_MIN_CELL_SHIFT;
+
+// Manifest hash of what each RAM table holds now; identical content isn't re-read
+static uint32_t collision_hash = ASSET_HASH_NONE;
+static uint32_t properties_hash = ASSET_HASH_NONE;
+static uint32_t waypoints_hash = ASSET_HASH_NONE;
+static uint32_t progress_hash = ASSET_HASH_NONE;
+static uint32_t checkpoints_hash = ASSET_HASH_NONE;
+
+// --- Large tracks: the map streams through the window in 8x8-tile chunks ---
+
+#define WINDOW_CHUNKS (MAP_WINDOW_TILES / MAP_CHUNK_TILES) // 8 per side
+#define CHUNK_PX      (MAP_CHUNK_TILES * 8)                // 64
+
+// A slot only ever holds chunks whose low 3 bits match it, so the high bits tag it
+#define CHUNK_TAG(cx, cy) ((((cy) >> 3) << 4) | ((cx) >> 3))
+#define CHUNK_NONE        0xFF
+
+static uint8_t window_chunk[WINDOW_CHUNKS][WINDOW_CHUNKS];
+static int stream_fd = -1;
+
+// Tile bank of every chunk of a banked track, 16 chunks to a row
+#define BANK_ROW_SHIFT 4 // TRACK_MAX_TILES / MAP_CHUNK_TILES = 16
+#define CHUNK_BANK(tx, ty) chunk_bank[((uint16_t)((ty) >> 3) << BANK_ROW_SHIFT) | ((tx) >> 3)]
+
+static uint8_t chunk_bank[(TRACK_MAX_TILES / MAP_CHUNK_TILES) * (TRACK_MAX_TILES / MAP_CHUNK_TILES)];
+static uint8_t shown_bank = 0;
+
+// --- Row cache: RAM copies of the window rows cars are driving over ---
+
+#define ROW_NONE           0xFF
+
+static uint8_t cache_rows[TERRAIN_CACHE_ROWS][MAP_WINDOW_TILES];
+static uint8_t cache_row_of[TERRAIN_CACHE_ROWS]; // Window row held, ROW_NONE = free
+static uint8_t cache_stamp[TERRAIN_CACHE_ROWS];  // Frame it was last wanted
+static uint8_t row_line[MAP_WINDOW_TILES];       // Window row -> cache line
+static uint8_t cache_frame = 0;
+
+uint16_t terrain_cache_misses = 0;
+uint16_t terrain_cache_fills = 0;
+uint16_t track_chunks_forced = 0;
+
+void terrain_cache_flush(void) {
+    memset(cache_row_of, ROW_NONE, sizeof(cache_row_of));
+    memset(row_line, ROW_NONE, sizeof(row_line));
+}
+
+// Reads window row wy into the line wanted longest ago
+static uint8_t cache_fill(uint8_t wy) {
+    uint8_t line = 0;
+    uint8_t oldest = 0;
+    for (uint8_t i = 0; i < TERRAIN_CACHE_ROWS; i++) {
+        if (cache_row_of[i] == ROW_NONE) {
+            line = i;
+            break;
+        }
+        uint8_t age = cache_frame - cache_stamp[i];
+        if (age > oldest) {
+            oldest = age;
+            line = i;
         }
-        total_read += bytes;
     }
-    
-    close(fd);
-    printf("Loaded %s to XRAM 0x%04X (%d bytes)\n", filename, dest_addr, total_read);
+
+    if (cache_row_of[line] != ROW_NONE) row_line[cache_row_of[line]] = ROW_NONE;
+    xram_read(track_map_xram + ((uint16_t)wy << 6), cache_rows[line], MAP_WINDOW_TILES);
+    cache_row_of[line] = wy;
+    cache_stamp[line] = cache_frame;
+    row_line[wy] = line;
+    terrain_cache_fills++;
+    return line;
 }
 
-// Helper to load file directly to RAM
-void load_file_to_ram(const char* filename, void* dest, uint16_t max_size) {
-    int fd = open(filename, O_RDONLY);
-    if (fd < 0) {
-        printf("Error opening %s\n", filename);
-        return;
+void terrain_cache_prefetch(uint16_t cam_x, uint16_t cam_y) {
+    cache_frame++;
+
+    for (uint8_t i = 0; i < NUM_CARS; i++) {
+        int16_t px = CAR_POS(car_x, i) >> 6;
+        int16_t py = CAR_POS(car_y, i) >> 6;
+
+        // Far off screen cars don't probe terrain (AI level of detail)
+        if (px + 16 + TERRAIN_CACHE_MARGIN < (int16_t)cam_x || px > (int16_t)cam_x + SCREEN_WIDTH + TERRAIN_CACHE_MARGIN ||
+            py + 16 + TERRAIN_CACHE_MARGIN < (int16_t)cam_y || py > (int16_t)cam_y + SCREEN_HEIGHT + TERRAIN_CACHE_MARGIN) {
+            continue;
+        }
+
+        // The 16 px sprite plus a tile of probes and push-outs either side
+        uint8_t ty0 = (py - 8) >> 3;
+        uint8_t ty1 = (py + 24) >> 3;
+        if (ty1 >= track_h_tiles) ty1 = track_h_tiles - 1;
+
+        for (uint8_t ty = ty0; ty <= ty1; ty++) {
+            uint8_t wy = ty & MAP_WINDOW_MASK;
+            uint8_t line = row_line[wy];
+            if (line == ROW_NONE) cache_fill(wy);
+            else cache_stamp[line] = cache_frame;
+        }
     }
-    
-    int bytes = read(fd, dest, max_size);
-    if (bytes < 0) printf("Error reading %s\n", filename);
-    else printf("Loaded %s to RAM (%d bytes)\n", filename, bytes);
-    
-    close(fd);
+}
+
+static void set_world_size(int track_id) {
+    const TrackLayout *layout = &track_layouts[track_id - 1];
+    track_w_tiles = layout->w_tiles;
+    track_h_tiles = layout->h_tiles;
+    track_banked = layout->banks > 1; // The tile tables hold TRACK_MAX_BANKS, the most of any track
+    world_w_px = (uint16_t)track_w_tiles << 3;
+    world_h_px = (uint16_t)track_h_tiles << 3;
+    world_max_x = (world_w_px - 8) << 6;
+    world_max_y = (world_h_px - 8) << 6;
+
+    // Maps exactly one window wide (and no taller) load whole
+    track_streaming = track_w_tiles != MAP_WINDOW_TILES || track_h_tiles > MAP_WINDOW_TILES;
+
+    // Progress cells double in size until the field fits (make_progress_field.py)
+    progress_cell_shift = PROGRESS_MIN_CELL_SHIFT;
+    while ((uint16_t)(world_w_px >> progress_cell_shift) * (world_h_px >> progress_cell_shift) > PROGRESS_FIELD_CELLS) {
+        progress_cell_shift++;
+    }
+    progress_field_width = world_w_px >> progress_cell_shift;
+}
+
+// Copies one chunk from the row-major map file into the window
+static void load_chunk(uint8_t cx, uint8_t cy) {
+    uint8_t sx = cx & (WINDOW_CHUNKS - 1);
+    uint8_t sy = cy & (WINDOW_CHUNKS - 1);
+    uint8_t row[MAP_CHUNK_TILES];
+
+    for (uint8_t r = 0; r < MAP_CHUNK_TILES; r++) {
+        uint8_t ty = cy * MAP_CHUNK_TILES + r;
+        uint8_t wy = ty & MAP_WINDOW_MASK;
+        uint8_t wx = sx * MAP_CHUNK_TILES;
+
+        lseek(stream_fd, (long)ty * track_w_tiles + cx * MAP_CHUNK_TILES, SEEK_SET);
+        if (read(stream_fd, row, MAP_CHUNK_TILES) != MAP_CHUNK_TILES) {
+            memset(row, 0, MAP_CHUNK_TILES);
+        }
+
+        xram_write(track_map_xram + ((uint16_t)wy << 6) + wx, row, MAP_CHUNK_TILES);
+
+        // Keep a cached copy of the row in step
+        if (row_line[wy] != ROW_NONE) memcpy(&cache_rows[row_line[wy]][wx], row, MAP_CHUNK_TILES);
+    }
+    window_chunk[sy][sx] = CHUNK_TAG(cx, cy);
+}
+
+// First chunk of the window on one axis: one behind the camera, kept on the map
+static uint8_t window_origin(uint16_t cam, uint8_t map_tiles) {
+    uint8_t chunks = map_tiles / MAP_CHUNK_TILES;
+    uint8_t c = cam / CHUNK_PX;
+    if (chunks <= WINDOW_CHUNKS) return 0;
+    if (c > 0) c--;
+    if (c > chunks - WINDOW_CHUNKS) c = chunks - WINDOW_CHUNKS;
+    return c;
+}
+
+bool track_stream_step(uint16_t cam_x, uint16_t cam_y) {
+    if (!track_streaming || stream_fd < 0) return false;
+
+    uint8_t ox = window_origin(cam_x, track_w_tiles);
+    uint8_t oy = window_origin(cam_y, track_h_tiles);
+    uint8_t chunks_w = track_w_tiles / MAP_CHUNK_TILES;
+    uint8_t chunks_h = track_h_tiles / MAP_CHUNK_TILES;
+
+    // Chunks under the screen first, then the margin around it
+    uint8_t vx0 = cam_x / CHUNK_PX;
+    uint8_t vy0 = cam_y / CHUNK_PX;
+    uint8_t vx1 = (cam_x + SCREEN_WIDTH - 1) / CHUNK_PX;
+    uint8_t vy1 = (cam_y + SCREEN_HEIGHT - 1) / CHUNK_PX;
+
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint8_t sy = 0; sy < WINDOW_CHUNKS; sy++) {
+            uint8_t cy = oy + ((sy - oy) & (WINDOW_CHUNKS - 1));
+            if (cy >= chunks_h) continue;
+            if (pass == 0 && (cy < vy0 || cy > vy1)) continue;
+
+            for (uint8_t sx = 0; sx < WINDOW_CHUNKS; sx++) {
+                uint8_t cx = ox + ((sx - ox) & (WINDOW_CHUNKS - 1));
+                if (cx >= chunks_w) continue;
+                if (pass == 0 && (cx < vx0 || cx > vx1)) continue;
+                if (window_chunk[sy][sx] == CHUNK_TAG(cx, cy)) continue;
+
+                load_chunk(cx, cy);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void track_stream_sync(uint16_t cam_x, uint16_t cam_y) {
+    uint8_t loaded = 0;
+    while (track_stream_step(cam_x, cam_y)) loaded++;
+    if (loaded) log_event(LOG_CHUNKS_STREAMED, loaded, 0, 0);
 }
 
 void load_track_data(int track_id) {
     char path[64];
-    
+
+    // Previous track stays resident (evictable) in case we come back to it.
+    // A streaming window is scratch and goes straight back to the heap.
+    if (track_streaming) {
+        xram_free(track_map_xram);
+        if (stream_fd >= 0) close(stream_fd);
+        stream_fd = -1;
+    } else {
+        xram_release(track_map_xram);
+    }
+    xram_release(track_tiles_xram);
+
+    set_world_size(track_id);
+
     // 1. Load Map to XRAM (and RAM copy)
     sprintf(path, "ROM:track%02d_map.bin", track_id);
-    load_file_to_xram(path, TRACK_MAP_ADDR, 3072);
-    
-    // Also read map into RAM for quick collision lookups
-    load_file_to_ram(path, world_map, sizeof(world_map));
+    if (track_streaming) {
+        // Only the window; chunks arrive through track_stream_step()
+        track_map_xram = xram_alloc("track window", MAP_WINDOW_TILES * MAP_WINDOW_TILES);
+        memset(window_chunk, CHUNK_NONE, sizeof(window_chunk));
+        stream_fd = open(path, O_RDONLY);
+        if (stream_fd < 0) log_event(LOG_OPEN_ERROR, asset_name_hash(path), 0, 0);
+    } else {
+        track_map_xram = xram_load(path, (uint16_t)track_w_tiles * track_h_tiles * MAP_BYTES_PER_TILE);
+    }
+    terrain_cache_flush(); // Collision probes read rows from XRAM on demand
 
-    // 2. Load Tiles to XRAM
+    // 2. Load Tiles to XRAM (every bank, back to back)
     sprintf(path, "ROM:track%02d_tiles.bin", track_id);
-    load_file_to_xram(path, TRACK_DATA, TRACK_DATA_SIZE);
+    track_tiles_xram = xram_load(path, TRACK_DATA_SIZE * track_layouts[track_id - 1].banks);
+    shown_bank = 0;
+
+    // Bank of each chunk, one row of the file per chunk row
+    if (track_banked) {
+        sprintf(path, "ROM:track%02d_banks.bin", track_id);
+        memset(chunk_bank, 0, sizeof(chunk_bank));
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            log_event(LOG_OPEN_ERROR, asset_name_hash(path), 0, 0);
+        } else {
+            uint8_t chunks_w = track_w_tiles / MAP_CHUNK_TILES;
+            for (uint8_t cy = 0; cy < track_h_tiles / MAP_CHUNK_TILES; cy++) {
+                read(fd, &chunk_bank[(uint16_t)cy << BANK_ROW_SHIFT], chunks_w);
+            }
+            close(fd);
+        }
+    }
+
+    // Point the track plane at wherever they live
+    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, xram_data_ptr, track_map_xram);
+    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, xram_tile_ptr, track_tiles_xram);
+    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, x_wrap, track_streaming);
+    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, y_wrap, track_streaming);
+    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, width_tiles,
+                     track_streaming ? MAP_WINDOW_TILES : track_w_tiles);
+    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, height_tiles,
+                     track_streaming ? MAP_WINDOW_TILES : track_h_tiles);
 
     // 3. Load Collision Masks to RAM
     sprintf(path, "ROM:track%02d_collision.bin", track_id);
-    load_file_to_ram(path, tile_collision_masks, sizeof(tile_collision_masks));
+    if (!asset_is_resident(path, &collision_hash)) {
+        memset(tile_collision_masks, 0, sizeof(tile_collision_masks)); // Default if the load fails
+        asset_loaded(path, &collision_hash,
+                     load_file_to_ram(path, tile_collision_masks, sizeof(tile_collision_masks)));
+    }
 
     // 4. Load Properties to RAM
     sprintf(path, "ROM:track%02d_properties.bin", track_id);
-    load_file_to_ram(path, tile_properties, sizeof(tile_properties));
+    if (!asset_is_resident(path, &properties_hash)) {
+        for (int i = 0; i < TRACK_MAX_TILE_IDS; i++) tile_properties[i] = TERRAIN_WALL; // Default if the load fails
+        asset_loaded(path, &properties_hash,
+                     load_file_to_ram(path, tile_properties, sizeof(tile_properties)));
+    }
 }
 
 #include "ai.h"
@@ -88,21 +335,32 @@ void load_track_data(int track_id) {
 uint16_t g_num_active_waypoints = NUM_WAYPOINTS;
 int current_track_id = 1;
 
-void load_waypoints(const char* filename) {
+// Distance along the racing line for each cell (see make_progress_field.py)
+uint16_t track_progress_field[PROGRESS_FIELD_CELLS];
+uint16_t track_lap_length = 0;
+
+TrackGate track_gates[MAX_GATES];
+uint8_t g_num_gates = 0;
+
+bool load_waypoints(const char* filename) {
     int fd = open(filename, O_RDONLY);
     if (fd < 0) {
-        printf("Error opening %s\n", filename);
-        return;
+        log_event(LOG_OPEN_ERROR, asset_name_hash(filename), 0, 0);
+        return false;
     }
 
     uint16_t file_count = 0;
     // 1. Read header (2 bytes)
-    read(fd, &file_count, 2);
+    if (read(fd, &file_count, 2) != 2) {
+        log_event(LOG_READ_ERROR, asset_name_hash(filename), 0, 0);
+        close(fd);
+        return false;
+    }
 
-    printf("Loading Waypoints: File has %d\n", file_count);
+    log_event(LOG_WAYPOINTS, file_count, 0, 0);
 
     if (file_count > NUM_WAYPOINTS) {
-        printf("Warning: Truncating waypoints to %d\n", NUM_WAYPOINTS);
+        log_event(LOG_WAYPOINTS_CUT, NUM_WAYPOINTS, 0, 0);
         g_num_active_waypoints = NUM_WAYPOINTS;
     } else {
         g_num_active_waypoints = file_count;
@@ -112,6 +370,63 @@ void load_waypoints(const char* filename) {
     read(fd, waypoints, g_num_active_waypoints * sizeof(Waypoint));
     
     close(fd);
+    return true;
+}
+
+bool load_progress_field(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        log_event(LOG_OPEN_ERROR, asset_name_hash(filename), 0, 0);
+        return false;
+    }
+
+    // 1. Read header (2 bytes): lap length in pixels
+    if (read(fd, &track_lap_length, 2) != 2) {
+        log_event(LOG_READ_ERROR, asset_name_hash(filename), 0, 0);
+        track_lap_length = 0;
+        close(fd);
+        return false;
+    }
+
+    // 2. Read the field directly into the array
+    read(fd, track_progress_field, sizeof(track_progress_field));
+
+    close(fd);
+    log_event(LOG_PROGRESS_LOADED, asset_name_hash(filename), track_lap_length, 0);
+    return true;
+}
+
+bool load_checkpoints(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        log_event(LOG_OPEN_ERROR, asset_name_hash(filename), 0, 0);
+        return false;
+    }
+
+    // 1. Read header (1 byte): gate count
+    uint8_t file_count = 0;
+    if (read(fd, &file_count, 1) != 1) {
+        log_event(LOG_READ_ERROR, asset_name_hash(filename), 0, 0);
+        close(fd);
+        return false;
+    }
+    if (file_count > MAX_GATES) file_count = MAX_GATES;
+
+    // 2. Read segments and precompute the test boxes once
+    for (uint8_t i = 0; i < file_count; i++) {
+        TrackGate *g = &track_gates[i];
+        read(fd, &g->x1, 8); // x1, y1, x2, y2
+
+        g->min_x = ((g->x1 < g->x2) ? g->x1 : g->x2) - GATE_MARGIN;
+        g->max_x = ((g->x1 > g->x2) ? g->x1 : g->x2) + GATE_MARGIN;
+        g->min_y = ((g->y1 < g->y2) ? g->y1 : g->y2) - GATE_MARGIN;
+        g->max_y = ((g->y1 > g->y2) ? g->y1 : g->y2) + GATE_MARGIN;
+    }
+    g_num_gates = file_count;
+
+    close(fd);
+    log_event(LOG_GATES_LOADED, asset_name_hash(filename), g_num_gates, 0);
+    return true;
 }
 
 // Track the currently loaded track to avoid redundant loads
@@ -119,13 +434,14 @@ static int last_loaded_track_id = -1;
 
 void load_track(int track_id) {
     if (track_id == last_loaded_track_id) {
-        printf("Track %d already loaded, skipping.\n", track_id);
+        log_event(LOG_TRACK_CACHED, track_id, 0, 0);
         return;
     }
 
-    // Defaults (in case load fails or partial load)
-    memset(tile_collision_masks, 0, sizeof(tile_collision_masks));
-    for (int i = 0; i < 256; i++) tile_properties[i] = TERRAIN_WALL;
+    TRACE_BEGIN(TR_TRACK_LOAD);
+
+    // Anything whose content is already resident is skipped (see assets.h)
+    uint32_t avoided_before = asset_bytes_avoided;
 
     // Load Map, Tiles, Collision, Properties
     load_track_data(track_id);
@@ -133,14 +449,37 @@ void load_track(int track_id) {
     // Load Waypoints
     char waypoints_file[64];
     sprintf(waypoints_file, "ROM:track%02d_waypoints.bin", track_id);
-    load_waypoints(waypoints_file);
+    if (!asset_is_resident(waypoints_file, &waypoints_hash)) {
+        asset_loaded(waypoints_file, &waypoints_hash, load_waypoints(waypoints_file));
+    }
+
+    // Load Progress Field (race order)
+    sprintf(waypoints_file, "ROM:track%02d_progress.bin", track_id);
+    if (!asset_is_resident(waypoints_file, &progress_hash)) {
+        memset(track_progress_field, 0, sizeof(track_progress_field));
+        track_lap_length = 0;
+        asset_loaded(waypoints_file, &progress_hash, load_progress_field(waypoints_file));
+    }
+
+    // Load Finish Line & Checkpoint Gates
+    sprintf(waypoints_file, "ROM:track%02d_checkpoints.bin", track_id);
+    if (!asset_is_resident(waypoints_file, &checkpoints_hash)) {
+        g_num_gates = 0;
+        asset_loaded(waypoints_file, &checkpoints_hash, load_checkpoints(waypoints_file));
+    }
 
     last_loaded_track_id = track_id;
+    log_event(LOG_TRACK_LOADED, track_id, (uint16_t)(asset_bytes_avoided - avoided_before),
+              (uint16_t)asset_bytes_avoided);
+
+    // Between races, so there's time to write out the load's records now
+    log_flush();
+    TRACE_END(TR_TRACK_LOAD);
 }
 
 uint8_t get_terrain_at(int16_t x, int16_t y) {
     // 1. Clamp to world bounds (handle negative and out-of-bounds)
-    if (x < 0 || y < 0 || x >= 512 || y >= 384) return TERRAIN_WALL;
+    if (x < 0 || y < 0 || x >= world_w_px || y >= world_h_px) return TERRAIN_WALL;
 
     // 2. Convert pixels to tile coordinates (8x8 tiles)
     uint8_t tx = x >> 3; // x / 8
@@ -148,24 +487,30 @@ uint8_t get_terrain_at(int16_t x, int16_t y) {
     uint8_t px = x & 7;  // Pixel within tile X (0-7)
     uint8_t py = y & 7;  // Pixel within tile Y (0-7)
 
-    // 3. Get Tile ID from the map (Width is 64, 1 byte per tile)
-    uint16_t map_index = ty * 64 + tx;
-    uint8_t tile_id = world_map[map_index];
-
-    // FIX: Explicitly report Finish Line tiles regardless of properties.bin
-    if (current_track_id == 3) {
-         if (tile_id == 14 || tile_id == 15 || tile_id == 44 || tile_id == 45) {
-            return TERRAIN_FINISH;
-        }
-    } else {
-        // Tiles 243-248 are defined as FINISH_LINE_TILES in the generator for Tracks 1 & 2
-        if (tile_id >= 243 && tile_id <= 248) {
-            return TERRAIN_FINISH;
-        }
+    // 3. Get Tile ID from the map window (64 wide, 1 byte per tile).
+    // On a big track the slot may still hold another chunk (streaming runs
+    // behind the camera): bring this one in rather than read the wrong
+    // tiles, and without a map to read treat it as solid.
+    if (track_streaming &&
+        window_chunk[(ty >> 3) & (WINDOW_CHUNKS - 1)][(tx >> 3) & (WINDOW_CHUNKS - 1)] != CHUNK_TAG(tx >> 3, ty >> 3)) {
+        if (stream_fd < 0) return TERRAIN_WALL;
+        load_chunk(tx >> 3, ty >> 3);
+        track_chunks_forced++;
+    }
+    uint8_t wy = ty & MAP_WINDOW_MASK;
+    uint8_t line = row_line[wy];
+    if (line == ROW_NONE) {
+        terrain_cache_misses++;
+        line = cache_fill(wy);
     }
+    uint8_t tile_id = cache_rows[line][tx & MAP_WINDOW_MASK];
 
-    // 4. Check pixel-level collision mask
-    uint8_t row_mask = tile_collision_masks[tile_id][py];
+    // 4. Check pixel-level collision mask. Byte-indexed tracks use the map
+    // byte as is; banked ones put the chunk's bank on top.
+    uint16_t gid = tile_id;
+    if (track_banked) gid |= (uint16_t)CHUNK_BANK(tx, ty) << 8;
+
+    uint8_t row_mask = tile_collision_masks[gid][py];
     if (row_mask != 0) {
         // This tile has collision data - check the specific pixel
         uint8_t pixel_mask = 0x80 >> px;  // Bit mask for this pixel (bit 7 to bit 0)
@@ -174,6 +519,36 @@ uint8_t get_terrain_at(int16_t x, int16_t y) {
         }
     }
 
-    // 5. Fall back to tile properties for tiles without collision masks
-    return tile_properties[tile_id];
+    // 5. Moving objects: only tiles a collider touches pay for the box test
+    if (num_colliders && (COLLIDER_TILE_BYTE(tx, ty) & (0x80 >> (tx & 7))) &&
+        collider_hit(x, y)) {
+        return TERRAIN_WALL;
+    }
+
+    // 6. Fall back to tile properties for tiles without collision masks
+    return tile_properties[gid];
+}
+
+void track_update_bank(uint16_t cam_x, uint16_t cam_y) {
+    if (!track_banked) return;
+
+    uint8_t tx = (cam_x + SCREEN_WIDTH / 2) >> 3;
+    uint8_t ty = (cam_y + SCREEN_HEIGHT / 2) >> 3;
+    uint8_t bank = CHUNK_BANK(tx, ty);
+    if (bank == shown_bank) return;
+
+    shown_bank = bank;
+    xram0_struct_set(TRACK_CONFIG, vga_mode2_config_t, xram_tile_ptr, track_tiles_xram + bank * TRACK_DATA_SIZE);
+}
+
+// One table read: distance along the racing line at pixel (x, y)
+uint16_t get_progress_at(int16_t x, int16_t y) {
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x >= world_w_px) x = world_w_px - 1;
+    if (y >= world_h_px) y = world_h_px - 1;
+
+    uint8_t cx = x >> progress_cell_shift;
+    uint8_t cy = y >> progress_cell_shift;
+    return track_progress_field[(uint16_t)cy * progress_field_width + cx];
 }
@@ -1,26 +1,126 @@
 #ifndef TRACK_H
 #define TRACK_H
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "cars.h"
+#include "constants.h"
+#include "track_layouts.h" // Generated (tools/track_layouts.cmake)
+
+// Tile property byte: surface type in bits 0-1, trigger id in bits 2-4.
+// get_terrain_at() returns the whole byte; walls never carry a trigger, so
+// "== TERRAIN_WALL" tests work on it unmasked.
 #define TERRAIN_ROAD  0
 #define TERRAIN_GRASS 1
 #define TERRAIN_WALL  2
-#define TERRAIN_BOOST 3
-#define TERRAIN_FINISH  3  // Checkpoint 0
-#define TERRAIN_CP1     4  // Checkpoint 1
-#define TERRAIN_CP2     5  // Checkpoint 2
-
-extern uint8_t world_map[3072];
-extern uint8_t tile_properties[256];
-extern uint8_t tile_collision_masks[256][8];
-extern void load_track(int track_id);
+#define TERRAIN_MASK  0x03
+
+#define TRIGGER_SHIFT  2
+#define TRIGGER_NONE   0
+#define TRIGGER_BOOST  1  // Boost pad: speed kick
+#define TRIGGER_OIL    2  // Slick: no grip or steering for a moment
+#define TRIGGER_PICKUP 3  // Fills the DRS charge
+
+#define TERRAIN_TYPE(t)    ((t) & TERRAIN_MASK)
+#define TERRAIN_TRIGGER(t) ((t) >> TRIGGER_SHIFT)
+
+// World size of the loaded track. 10.6 car positions reach 1023 px, so a
+// track can be up to 128x128 tiles; both sides must be multiples of 8.
+#define TRACK_MAX_TILES 128
+#define WORLD_MIN_10_6  0x200 // Cars are kept 8 px inside the edges
+
+extern uint8_t track_w_tiles, track_h_tiles;
+extern uint16_t world_w_px, world_h_px;
+extern uint16_t world_max_x, world_max_y; // 10.6 clamp for a car's top-left
+
+// The map lives only in XRAM, as a 64x64 tile window that wraps: tile
+// (tx, ty) is at ((ty & 63) << 6) | (tx & 63). Tracks that fit load whole;
+// bigger ones stream in as 8x8-tile chunks around the camera, one chunk per
+// track_stream_step().
+#define MAP_WINDOW_TILES 64
+#define MAP_WINDOW_MASK  (MAP_WINDOW_TILES - 1)
+#define MAP_CHUNK_TILES  8
+
+extern bool track_streaming; // Active track is larger than the window
+
+// get_terrain_at() reads a RAM cache of whole window rows. Each frame
+// terrain_cache_prefetch() pulls in the rows under every car near the
+// camera; a probe outside them fetches its row on the spot and counts a miss.
+// Six rows per car (a car spans at most 5), but never more than cars near
+// the screen can reach: from the top of a sprite TERRAIN_CACHE_MARGIN above
+// the screen to the bottom of one that far below it, a tile of probes either
+// side, and one more for a sprite that straddles a row.
+#define TERRAIN_CACHE_MARGIN 32 // Pixels around the screen, as AI_LOD_MARGIN (ai.c)
+#define TERRAIN_CACHE_SCREEN_ROWS ((SCREEN_HEIGHT + 2 * TERRAIN_CACHE_MARGIN + 2 * 16 + 2 * 8) / 8 + 1)
+#ifndef TERRAIN_CACHE_ROWS
+#define TERRAIN_CACHE_ROWS (6 * NUM_CARS < TERRAIN_CACHE_SCREEN_ROWS ? 6 * NUM_CARS : TERRAIN_CACHE_SCREEN_ROWS)
+#endif
+
+extern void terrain_cache_flush(void);
+extern void terrain_cache_prefetch(uint16_t cam_x, uint16_t cam_y);
+extern uint16_t terrain_cache_misses; // Rows a probe had to fetch itself
+extern uint16_t terrain_cache_fills;  // Rows fetched from XRAM, prefetch included
+extern uint16_t track_chunks_forced;  // Chunks a probe had to stream in itself
+
+// Camera is the world pixel at the screen's top-left. Returns false once
+// every chunk the window needs is resident.
+extern bool track_stream_step(uint16_t cam_x, uint16_t cam_y);
+extern void track_stream_sync(uint16_t cam_x, uint16_t cam_y);
+// Mode 2 maps index tiles with one byte. Tilesets beyond 256 tiles come in
+// banks of 256: each 8x8-tile chunk of the map uses one bank (banks.bin),
+// and a tile's global id is (bank << 8) | map byte. The plane shows the
+// bank of the chunk at the screen centre; process_track.py checks that
+// everything else on screen draws the same in that bank.
+// The tile tables below hold TRACK_MAX_BANKS banks (9 bytes a tile), the
+// most any tiles.bin has (track_layouts.h); tracks can't use more.
+#define TILES_PER_BANK   256
+#define TRACK_MAX_TILE_IDS (TILES_PER_BANK * TRACK_MAX_BANKS)
+
+extern uint8_t tile_properties[TRACK_MAX_TILE_IDS];
+extern uint8_t tile_collision_masks[TRACK_MAX_TILE_IDS][8];
+extern bool track_banked; // More than one bank: probes look up the chunk's bank
+extern void track_update_bank(uint16_t cam_x, uint16_t cam_y);
 extern void load_track(int track_id);
 extern void load_track_data(int track_id);
+extern uint16_t track_map_xram;   // XRAM address of the active track map
+extern uint16_t track_tiles_xram; // XRAM address of the active track tiles
 
-#define NUM_TRACKS 3 
+// One per track directory in CMakeLists.txt. The bench adds a 4th: track01
+// padded past the window, so it streams.
+#define NUM_TRACKS TRACK_LAYOUT_COUNT
 
-extern void load_waypoints(const char* filename);
+extern bool load_waypoints(const char* filename);
 extern uint8_t get_terrain_at(int16_t x, int16_t y);
 
+// Track progress field: distance along the racing line per cell. Cells are
+// 16x16 px, doubled until the field fits (see make_progress_field.py).
+#define PROGRESS_MIN_CELL_SHIFT 4
+#define PROGRESS_FIELD_CELLS    1024
+
+extern uint16_t track_progress_field[PROGRESS_FIELD_CELLS];
+extern uint8_t progress_cell_shift;
+extern uint8_t progress_field_width;
+extern uint16_t track_lap_length; // Pixels around the loop (0 if no field loaded)
+
+extern bool load_progress_field(const char* filename);
+extern uint16_t get_progress_at(int16_t x, int16_t y);
+
+// Finish line and checkpoint gates (see make_checkpoints.py)
+// Gate 0 is the finish line; gates 1..N-1 must be crossed in order.
+#define MAX_GATES    8
+#define GATE_MARGIN  16  // Pixels around a gate where cars are tested (> max speed per frame)
+
+typedef struct {
+    int16_t x1, y1, x2, y2;         // Segment; forward crossing goes from - to + side
+    int16_t min_x, min_y;           // Test box (segment bounds + GATE_MARGIN)
+    int16_t max_x, max_y;
+} TrackGate;
+
+extern TrackGate track_gates[MAX_GATES];
+extern uint8_t g_num_gates;
+
+extern bool load_checkpoints(const char* filename);
+
 extern uint16_t g_num_active_waypoints;
 extern int current_track_id; // Default 1
 
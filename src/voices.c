@@ -0,0 +1,152 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "voices.h"
+#include "opl.h"
+
+// Everything the music last wrote, indexed by its own (unmapped) register
+static uint8_t music_regs[256];
+
+static uint8_t music_map[OPL_CHANNELS];  // Music channel -> physical (VOICE_NONE = muted)
+static uint8_t phys_music[OPL_CHANNELS]; // Physical -> music channel (VOICE_NONE = none)
+static uint8_t claim_prio[OPL_CHANNELS]; // Physical -> SFX priority (0 = unclaimed)
+static uint16_t music_used = 0;          // Music channels the song has touched
+
+// Operator slot (reg & 0x1F) -> channel
+static const uint8_t slot_channel[0x16] = {
+    0, 1, 2, 0, 1, 2, VOICE_NONE, VOICE_NONE,
+    3, 4, 5, 3, 4, 5, VOICE_NONE, VOICE_NONE,
+    6, 7, 8, 6, 7, 8
+};
+
+// Operator register groups, restored when a music channel moves
+static const uint8_t op_regs[] = {0x20, 0x40, 0x60, 0x80, 0xE0};
+
+// Channel a register belongs to, or VOICE_NONE for global registers
+static uint8_t reg_channel(uint8_t reg) {
+    if (reg >= 0xA0 && reg < 0xD0) {
+        uint8_t ch = reg & 0x0F; // A0-A8, B0-B8, C0-C8 (0xBD is global)
+        return (ch < OPL_CHANNELS) ? ch : VOICE_NONE;
+    }
+    if ((reg >= 0x20 && reg < 0xA0) || reg >= 0xE0) {
+        uint8_t slot = reg & 0x1F;
+        return (slot < sizeof(slot_channel)) ? slot_channel[slot] : VOICE_NONE;
+    }
+    return VOICE_NONE;
+}
+
+// The same register moved from channel ch to physical channel p
+static uint8_t reg_on(uint8_t reg, uint8_t ch, uint8_t p) {
+    if (reg >= 0xA0 && reg < 0xD0) return reg - ch + p;
+    bool carrier = (reg & 0x1F) == opl_car_offsets[ch];
+    return (reg & 0xE0) + (carrier ? opl_car_offsets[p] : opl_mod_offsets[p]);
+}
+
+// Rebuild music channel ch's patch and pitch on physical channel p
+static void restore_music_channel(uint8_t ch, uint8_t p) {
+    for (uint8_t i = 0; i < sizeof(op_regs); i++) {
+        uint8_t m = op_regs[i] + opl_mod_offsets[ch];
+        uint8_t c = op_regs[i] + opl_car_offsets[ch];
+        opl_write(reg_on(m, ch, p), music_regs[m]);
+        opl_write(reg_on(c, ch, p), music_regs[c]);
+    }
+    opl_write(0xC0 + p, music_regs[0xC0 + ch]);
+    opl_write(0xA0 + p, music_regs[0xA0 + ch]);
+    opl_write(0xB0 + p, music_regs[0xB0 + ch]);
+    shadow_b0[p] = music_regs[0xB0 + ch] & 0x1F;
+}
+
+static void map_music(uint8_t ch, uint8_t p) {
+    music_map[ch] = p;
+    phys_music[p] = ch;
+    if (music_used & (1 << ch)) restore_music_channel(ch, p);
+}
+
+void voices_init(void) {
+    for (uint8_t i = 0; i < OPL_CHANNELS; i++) {
+        music_map[i] = i;
+        phys_music[i] = i;
+        claim_prio[i] = 0;
+    }
+    for (uint16_t r = 0; r < 256; r++) music_regs[r] = 0;
+    music_used = 0;
+}
+
+void opl_music_write(uint8_t reg, uint8_t val) {
+    music_regs[reg] = val;
+
+    uint8_t ch = reg_channel(reg);
+    if (ch == VOICE_NONE) {
+        opl_write(reg, val);
+        return;
+    }
+    music_used |= 1 << ch;
+
+    uint8_t p = music_map[ch];
+    if (p == VOICE_NONE) return; // Taken by an SFX: shadow only
+    opl_write(reg_on(reg, ch, p), val);
+    if (reg >= 0xB0 && reg < 0xB0 + OPL_CHANNELS) shadow_b0[p] = val & 0x1F;
+}
+
+uint8_t opl_music_read(uint8_t reg) {
+    return music_regs[reg];
+}
+
+void opl_music_silence(void) {
+    for (uint8_t ch = 0; ch < OPL_CHANNELS; ch++) {
+        music_regs[0xB0 + ch] &= ~0x20;
+        uint8_t p = music_map[ch];
+        if (p != VOICE_NONE) opl_write(0xB0 + p, music_regs[0xB0 + ch]);
+    }
+}
+
+uint8_t opl_voice_claim(uint8_t priority) {
+    uint8_t pick = VOICE_NONE;
+
+    // 1. A channel no music channel is (or has been) playing on.
+    //    Search from the top: songs tend to fill the low channels first.
+    for (int8_t p = OPL_CHANNELS - 1; p >= 0; p--) {
+        if (claim_prio[p]) continue;
+        uint8_t ch = phys_music[p];
+        if (ch == VOICE_NONE || !(music_used & (1 << ch))) { pick = p; break; }
+    }
+
+    // 2. Take one from the music, preferring a channel between notes
+    if (pick == VOICE_NONE && priority > VOICE_PRIO_MUSIC) {
+        for (int8_t p = OPL_CHANNELS - 1; p >= 0; p--) {
+            if (claim_prio[p]) continue;
+            if (pick == VOICE_NONE) pick = p;
+            if (!(music_regs[0xB0 + phys_music[p]] & 0x20)) { pick = p; break; }
+        }
+    }
+    if (pick == VOICE_NONE) return VOICE_NONE;
+
+    // Evict the music channel living there
+    uint8_t ch = phys_music[pick];
+    claim_prio[pick] = priority;
+    phys_music[pick] = VOICE_NONE;
+    opl_write(0xB0 + pick, shadow_b0[pick]); // Key off
+    if (ch != VOICE_NONE) {
+        music_map[ch] = VOICE_NONE;
+        for (uint8_t q = 0; q < OPL_CHANNELS; q++) {
+            if (!claim_prio[q] && phys_music[q] == VOICE_NONE) {
+                map_music(ch, q);
+                break;
+            }
+        }
+    }
+    return pick;
+}
+
+void opl_voice_release(uint8_t p) {
+    if (p >= OPL_CHANNELS || !claim_prio[p]) return;
+    claim_prio[p] = 0;
+    opl_write(0xB0 + p, shadow_b0[p]); // Key off the effect
+
+    // Give it back to a muted music channel, if any
+    for (uint8_t ch = 0; ch < OPL_CHANNELS; ch++) {
+        if (music_map[ch] == VOICE_NONE) {
+            map_music(ch, p);
+            return;
+        }
+    }
+}
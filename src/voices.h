@@ -0,0 +1,36 @@
+#ifndef VOICES_H
+#define VOICES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// OPL channel arbitration between the music stream and sound effects.
+//
+// The music writes to "music channels" 0-8. Those normally land on the same
+// physical channel, but an SFX can claim a physical channel by priority.
+// The music channel that lived there is moved to a spare physical channel
+// (its patch restored from the shadow registers) or, with no spare, keeps
+// running silently in the shadow until the SFX releases the channel.
+// Lower-priority claims only get channels the music isn't using.
+
+#define OPL_CHANNELS  9
+#define VOICE_NONE    0xFF
+
+#define VOICE_PRIO_MUSIC   2 // Claims above this may take channels from the music
+#define VOICE_PRIO_AMBIENT 1 // Spare channels only (boost)
+#define VOICE_PRIO_ENGINE  3 // Held from race start to finish
+#define VOICE_PRIO_CRASH   4 // Car and wall hits
+
+extern void voices_init(void); // Called by opl_init()
+
+// Every music register write goes through here (vsync IRQ)
+extern void opl_music_write(uint8_t reg, uint8_t val);
+extern uint8_t opl_music_read(uint8_t reg); // Last value the music wrote
+// Key off the music's notes only; claimed channels keep playing
+extern void opl_music_silence(void);
+
+// Returns the physical channel now owned by the caller, or VOICE_NONE
+extern uint8_t opl_voice_claim(uint8_t priority);
+extern void opl_voice_release(uint8_t channel);
+
+#endif // VOICES_H
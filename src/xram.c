@@ -0,0 +1,203 @@
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <rp6502.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "xram.h"
+#include "assets.h"
+#include "log.h"
+
+#define BLOCK_FREE       0
+#define BLOCK_PERMANENT  1 // xram_alloc(): never evicted
+#define BLOCK_ASSET      2 // Loaded file; evictable while refs == 0
+
+typedef struct {
+    uint16_t addr;
+    uint16_t size;
+    uint8_t state;
+    uint8_t refs;             // Holders of an asset (xram_load - xram_release)
+    uint8_t last_use;         // Load stamp for LRU eviction
+    uint32_t hash;            // Content hash from the manifest (ASSET_HASH_NONE if unknown)
+    char name[XRAM_NAME_LEN];
+} XramBlock;
+
+// Sorted by address and covering the whole heap, free blocks included
+static XramBlock blocks[XRAM_MAX_BLOCKS];
+static uint8_t num_blocks = 0;
+static uint8_t use_clock = 0;
+
+void xram_init(void) {
+    blocks[0].addr = XRAM_HEAP_START;
+    blocks[0].size = XRAM_HEAP_END - XRAM_HEAP_START;
+    blocks[0].state = BLOCK_FREE;
+    blocks[0].name[0] = '\0';
+    num_blocks = 1;
+}
+
+static int8_t find_block(uint16_t addr) {
+    for (uint8_t i = 0; i < num_blocks; i++) {
+        if (blocks[i].addr == addr && blocks[i].state != BLOCK_FREE) return i;
+    }
+    return -1;
+}
+
+// Same content counts as resident even under another file name
+static int8_t find_asset(const char* name, uint32_t hash) {
+    for (uint8_t i = 0; i < num_blocks; i++) {
+        if (blocks[i].state != BLOCK_ASSET) continue;
+        if (hash != ASSET_HASH_NONE) {
+            if (blocks[i].hash == hash) return i;
+        } else if (strcmp(blocks[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void remove_block(uint8_t i) {
+    memmove(&blocks[i], &blocks[i + 1], (num_blocks - i - 1) * sizeof(XramBlock));
+    num_blocks--;
+}
+
+// Mark a block free and merge it with free neighbours
+static void release_block(uint8_t i) {
+    blocks[i].state = BLOCK_FREE;
+    blocks[i].name[0] = '\0';
+
+    if (i + 1 < num_blocks && blocks[i + 1].state == BLOCK_FREE) {
+        blocks[i].size += blocks[i + 1].size;
+        remove_block(i + 1);
+    }
+    if (i > 0 && blocks[i - 1].state == BLOCK_FREE) {
+        blocks[i - 1].size += blocks[i].size;
+        remove_block(i);
+    }
+}
+
+// Free the cached asset that was loaded longest ago
+static bool evict_one(void) {
+    int8_t victim = -1;
+    uint8_t oldest = 0;
+    for (uint8_t i = 0; i < num_blocks; i++) {
+        if (blocks[i].state != BLOCK_ASSET || blocks[i].refs) continue;
+        uint8_t age = use_clock - blocks[i].last_use;
+        if (victim < 0 || age > oldest) {
+            victim = i;
+            oldest = age;
+        }
+    }
+    if (victim < 0) return false;
+
+    log_event(LOG_XRAM_EVICT, asset_name_hash(blocks[victim].name), blocks[victim].size, 0);
+    release_block(victim);
+    return true;
+}
+
+static int8_t alloc_block(const char* name, uint16_t size, uint8_t state) {
+    if (size == 0) return -1;
+
+    do {
+        // First fit
+        for (uint8_t i = 0; i < num_blocks; i++) {
+            XramBlock *b = &blocks[i];
+            if (b->state != BLOCK_FREE || b->size < size) continue;
+
+            // Split off the remainder. With the table full only an exact fit
+            // will do: handing out the whole block would lose the rest of it
+            // until this one is freed. Evicting merges entries back.
+            if (b->size > size) {
+                if (num_blocks == XRAM_MAX_BLOCKS) continue;
+                memmove(&blocks[i + 1], &blocks[i], (num_blocks - i) * sizeof(XramBlock));
+                num_blocks++;
+                blocks[i + 1].addr = b->addr + size;
+                blocks[i + 1].size = b->size - size;
+                b->size = size;
+            }
+
+            b->state = state;
+            b->refs = 0;
+            b->last_use = use_clock;
+            b->hash = ASSET_HASH_NONE;
+            strncpy(b->name, name, XRAM_NAME_LEN - 1);
+            b->name[XRAM_NAME_LEN - 1] = '\0';
+            return i;
+        }
+    } while (evict_one());
+
+    log_event(num_blocks == XRAM_MAX_BLOCKS ? LOG_XRAM_TABLE_FULL : LOG_XRAM_FULL,
+              asset_name_hash(name), size, 0);
+    return -1;
+}
+
+uint16_t xram_alloc(const char* name, uint16_t size) {
+    int8_t i = alloc_block(name, size, BLOCK_PERMANENT);
+    return (i < 0) ? XRAM_NULL : blocks[i].addr;
+}
+
+void xram_free(uint16_t addr) {
+    int8_t i = find_block(addr);
+    if (i >= 0) release_block(i);
+}
+
+uint16_t xram_load(const char* filename, uint16_t max_size) {
+    use_clock++;
+
+    // Already resident: no file I/O at all
+    uint32_t hash = asset_hash(filename);
+    int8_t i = find_asset(filename, hash);
+    if (i >= 0) {
+        XramBlock *b = &blocks[i];
+        b->refs++;
+        b->last_use = use_clock;
+        if (hash != ASSET_HASH_NONE) asset_bytes_avoided += asset_size(filename);
+        log_event(LOG_XRAM_RESIDENT, asset_name_hash(filename), b->addr, 0);
+        return b->addr;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        log_event(LOG_OPEN_ERROR, asset_name_hash(filename), 0, 0);
+        return XRAM_NULL;
+    }
+
+    i = alloc_block(filename, max_size, BLOCK_ASSET);
+    if (i < 0) {
+        close(fd);
+        return XRAM_NULL;
+    }
+
+    // read_xram streams straight from the file into XRAM
+    uint16_t addr = blocks[i].addr;
+    int bytes = read_xram(addr, max_size, fd);
+    close(fd);
+    if (bytes <= 0) {
+        // Not resident after all: a later load retries the file
+        log_event(LOG_READ_ERROR, asset_name_hash(filename), 0, 0);
+        release_block(i);
+        return XRAM_NULL;
+    }
+
+    // Only now does the block hold the content the hash names
+    blocks[i].refs = 1;
+    blocks[i].hash = hash;
+    log_event(LOG_XRAM_LOAD, asset_name_hash(filename), addr, 0);
+    return addr;
+}
+
+void xram_release(uint16_t addr) {
+    int8_t i = find_block(addr);
+    if (i >= 0 && blocks[i].state == BLOCK_ASSET && blocks[i].refs) blocks[i].refs--;
+}
+
+bool xram_is_resident(const char* filename) {
+    return find_asset(filename, asset_hash(filename)) >= 0;
+}
+
+void xram_print_map(void) {
+    static const char* const state_names[] = {"free", "fixed", "asset"};
+    for (uint8_t i = 0; i < num_blocks; i++) {
+        printf("XRAM 0x%04X %5u %-5s %u %s\n", blocks[i].addr, blocks[i].size,
+               state_names[blocks[i].state], blocks[i].refs, blocks[i].name);
+    }
+}
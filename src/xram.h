@@ -0,0 +1,42 @@
+#ifndef XRAM_H
+#define XRAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "constants.h"
+
+// XRAM region allocator with a residency cache for ROM assets.
+//
+// Everything between the boot image (car sprites and boot configs, placed
+// by the ROM loader) and the fixed device registers at the top of XRAM is
+// handed out here. Configs are allocated once and never move. Tile sets and maps
+// are assets: once loaded they stay resident after release, and a later
+// xram_load() of the same content (matched by manifest hash, so two files
+// with identical bytes share one copy) just returns the address. Released
+// assets are evicted least-recently-used first when space runs out.
+
+#define XRAM_HEAP_START  BOOT_IMAGE_END  // Below: car sprites, boot image
+#define XRAM_HEAP_END    OPL_ADDR        // Above: OPL, palette, input, PSG
+#define XRAM_NULL        0xFFFFU
+
+#define XRAM_MAX_BLOCKS  20  // Free and used regions together
+#define XRAM_NAME_LEN    24  // Fits "ROM:trackNN_tiles.bin"
+
+extern void xram_init(void);
+
+// Permanent regions (configs, text RAM). Returns XRAM_NULL when full.
+extern uint16_t xram_alloc(const char* name, uint16_t size);
+extern void xram_free(uint16_t addr);
+
+// Named assets: load (or find resident) and hold until released
+extern uint16_t xram_load(const char* filename, uint16_t max_size);
+extern void xram_release(uint16_t addr);
+extern bool xram_is_resident(const char* filename);
+
+extern void xram_print_map(void);
+
+// Copy between XRAM and RAM through portal 0 (xram_io.c; the bench stubs them)
+extern void xram_read(uint16_t addr, void* dst, uint16_t count);
+extern void xram_write(uint16_t addr, const void* src, uint16_t count);
+
+#endif // XRAM_H
@@ -0,0 +1,19 @@
+#include <stdint.h>
+#include <rp6502.h>
+#include "xram.h"
+
+// Kept out of xram.c so the bench can swap in RAM-backed versions: the
+// bench's RIA is a plain struct and can't read anything back.
+void xram_read(uint16_t addr, void* dst, uint16_t count) {
+    uint8_t *p = (uint8_t *)dst;
+    RIA.addr0 = addr;
+    RIA.step0 = 1;
+    while (count--) *p++ = RIA.rw0;
+}
+
+void xram_write(uint16_t addr, const void* src, uint16_t count) {
+    const uint8_t *p = (const uint8_t *)src;
+    RIA.addr0 = addr;
+    RIA.step0 = 1;
+    while (count--) RIA.rw0 = *p++;
+}
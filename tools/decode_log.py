@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+Render the game's binary log (racelog.bin, see src/log.h) as text.
+
+The game stores each log_event() as an 8-byte record instead of calling
+printf. Event ids and format strings come from the LOG_EVENTS list in
+src/log.h, in order, so the decoder always matches the header it's given.
+Asset names are logged as 16-bit name hashes and looked up among the
+rom_asset() entries in CMakeLists.txt, plus the XRAM block and task names
+given to xram_alloc() and sched_add() in src/.
+
+File format (little endian):
+- header: "RLOG", uint8 version, uint8 record size
+- records: uint8 id, uint8 vsync, uint16 args[3]
+
+Usage: ./decode_log.py <racelog.bin> [--header src/log.h] [--cmake CMakeLists.txt] [--src src]
+"""
+
+import sys
+import os
+import re
+import argparse
+import struct
+
+from make_asset_manifest import name_hash
+
+LOG_VERSION = 1  # Must match log.h
+HEADER = b"RLOG"
+RECORD = struct.Struct("<BB3H")
+PACE_STAGES = ["video", "input", "player", "ai", "collide", "logic", "tasks"]  # pacing.h
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+
+
+def load_formats(header_path):
+    """Format strings from the X(id, "format") lines of LOG_EVENTS, in id order."""
+    with open(header_path) as f:
+        text = f.read()
+    block = text[text.index("#define LOG_EVENTS(X)"):]
+    block = block[:block.index("\n\n")]
+    return [(name, fmt) for name, fmt in re.findall(r'X\((\w+),\s*"((?:[^"\\]|\\.)*)"\)', block)]
+
+
+def load_asset_names(cmake_path):
+    """Name hash -> "ROM:<name>" for every rom_asset() in CMakeLists.txt."""
+    names = {}
+    with open(cmake_path) as f:
+        for name in re.findall(r'^\s*rom_asset\((\S+)\s', f.read(), re.M):
+            names[name_hash("ROM:" + name)] = "ROM:" + name
+    return names
+
+
+def load_source_names(src_dir):
+    """Name hash -> name for the string literals passed to xram_alloc() and sched_add()."""
+    names = {}
+    for file in sorted(os.listdir(src_dir)):
+        if file.endswith(".c"):
+            with open(os.path.join(src_dir, file)) as f:
+                for name in re.findall(r'\b(?:xram_alloc|sched_add)\(\s*"([^"]*)"', f.read()):
+                    names[name_hash(name)] = name
+    return names
+
+
+def render(fmt, args, asset_names):
+    """printf-style %u/%d/%X plus %a (name hash), %C (car slot), %P (pacing stage)."""
+    args = list(args)
+
+    def convert(m):
+        spec = m.group(0)
+        if spec == "%%":
+            return "%"
+        value = args.pop(0) if args else 0
+        conv = spec[-1]
+        if conv == "a":
+            return asset_names.get(value, f"name#{value:04X}")
+        if conv == "C":
+            return "Player" if value == 0 else f"AI {value}"
+        if conv == "P":
+            return PACE_STAGES[value] if value < len(PACE_STAGES) else f"stage {value}"
+        if conv == "d":
+            value = value - 0x10000 if value & 0x8000 else value
+            spec = spec[:-1] + "d"
+        return spec % value
+
+    return re.sub(r"%%|%[-0-9]*[udxXaCP]", convert, fmt)
+
+
+def decode(log_path, formats, asset_names):
+    with open(log_path, 'rb') as f:
+        data = f.read()
+
+    if data[:4] != HEADER:
+        print(f"Error: {log_path} is not a log file")
+        sys.exit(1)
+    version, record_size = data[4], data[5]
+    if version != LOG_VERSION or record_size != RECORD.size:
+        print(f"Error: Log version {version} / record size {record_size}, "
+              f"expected {LOG_VERSION} / {RECORD.size}")
+        sys.exit(1)
+
+    body = data[6:]
+    for offset in range(0, len(body) - RECORD.size + 1, RECORD.size):
+        event_id, vsync, *args = RECORD.unpack_from(body, offset)
+        if event_id < len(formats):
+            text = render(formats[event_id][1], args, asset_names)
+        else:
+            text = f"Unknown event {event_id} {args}"
+        print(f"[{vsync:3d}] {text}")
+
+    if len(body) % RECORD.size:
+        print(f"Warning: {len(body) % RECORD.size} trailing bytes (log cut short)")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Decode the game's binary log")
+    parser.add_argument("log", help="racelog.bin from the USB drive")
+    parser.add_argument("--header", default=os.path.join(ROOT, "src", "log.h"))
+    parser.add_argument("--cmake", default=os.path.join(ROOT, "CMakeLists.txt"))
+    parser.add_argument("--src", default=os.path.join(ROOT, "src"))
+    args = parser.parse_args()
+
+    if not os.path.exists(args.log):
+        print(f"Error: File not found: {args.log}")
+        sys.exit(1)
+
+    names = load_source_names(args.src)
+    names.update(load_asset_names(args.cmake))
+    decode(args.log, load_formats(args.header), names)
@@ -15,6 +15,7 @@ local height = img.height -- Should be 48
 -- Prompt for save location
 local dlg = Dialog("Export RP6502 Map")
 dlg:file{ id="export_file", label="Save as:", save=true, filename="track_map.bin" }
+dlg:check{ id="wide", text="16-bit indices (tilesets over 256 tiles, see process_track.py --map16)", selected=false }
 dlg:button{ id="ok", text="Export" }
 dlg:button{ id="cancel", text="Cancel" }
 dlg:show()
@@ -30,11 +31,17 @@ if dlg.data.ok then
             -- app.pixelColor.tileI extracts the index from the internal data
             local tileIndex = app.pixelColor.tileI(pixel)
             
-            -- Write as a single byte (0-255)
-            f:write(string.char(tileIndex & 0xFF))
+            if dlg.data.wide then
+                -- Two bytes, little endian (0-65535)
+                f:write(string.char(tileIndex & 0xFF, (tileIndex >> 8) & 0xFF))
+            else
+                -- Write as a single byte (0-255)
+                f:write(string.char(tileIndex & 0xFF))
+            end
         end
     end
     
     f:close()
-    app.alert("Exported " .. (width*height) .. " bytes to " .. dlg.data.export_file)
+    local bytes = width * height * (dlg.data.wide and 2 or 1)
+    app.alert("Exported " .. bytes .. " bytes to " .. dlg.data.export_file)
 end
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+Build the asset manifest: a content hash for every named ROM asset.
+
+The game reads ROM:manifest.bin at boot. Before uploading an asset to XRAM
+or RAM the loader compares its content hash with whatever is already
+resident and skips the upload on a match (e.g. track01 and track02 share
+the same tiles.bin).
+
+Output format (little endian):
+- uint8  entry_count
+- per entry:
+    uint16 name_hash       (asset_name_hash() in assets.c, over "ROM:<name>")
+    uint16 size            (bytes, capped at 0xFFFF)
+    uint32 content_hash    (FNV-1a 32 of the file; never 0)
+
+Usage: ./make_asset_manifest.py <manifest.bin> <name> <file> [<name> <file> ...]
+Normally run by CMake with every asset registered through rom_asset().
+"""
+
+import sys
+import os
+import struct
+
+MAX_ENTRIES = 40  # Must match MAX_MANIFEST_ENTRIES in assets.h
+
+
+def name_hash(name):
+    """16-bit shift-xor hash; must match asset_name_hash() in assets.c."""
+    h = 5381
+    for ch in name.encode('ascii'):
+        h = ((h << 5) + h) & 0xFFFF
+        h ^= ch
+    return h
+
+
+def content_hash(data):
+    """FNV-1a 32. 0 is reserved for 'unknown'."""
+    h = 0x811C9DC5
+    for b in data:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h or 1
+
+
+def make_manifest(output_file, pairs):
+    if len(pairs) > MAX_ENTRIES:
+        print(f"Error: {len(pairs)} assets, manifest holds {MAX_ENTRIES}")
+        sys.exit(1)
+
+    entries = []
+    seen = {}
+    for name, path in pairs:
+        rom_name = f"ROM:{name}"
+        nh = name_hash(rom_name)
+        if nh in seen:
+            print(f"Error: Name hash collision between {seen[nh]} and {rom_name}")
+            sys.exit(1)
+        seen[nh] = rom_name
+
+        with open(path, 'rb') as f:
+            data = f.read()
+        entries.append((nh, min(len(data), 0xFFFF), content_hash(data)))
+
+    with open(output_file, 'wb') as f:
+        f.write(struct.pack('<B', len(entries)))
+        for nh, size, ch in entries:
+            f.write(struct.pack('<HHI', nh, size, ch))
+
+    unique = len({ch for _, _, ch in entries})
+    print(f"Wrote {len(entries)} assets ({unique} unique contents) to {output_file}")
+
+
+if __name__ == "__main__":
+    args = sys.argv[1:]
+    if len(args) < 3 or len(args) % 2 != 1:
+        print(f"Usage: {sys.argv[0]} <manifest.bin> <name> <file> [<name> <file> ...]")
+        sys.exit(1)
+
+    pairs = list(zip(args[1::2], args[2::2]))
+    for _, path in pairs:
+        if not os.path.exists(path):
+            print(f"Error: File not found: {path}")
+            sys.exit(1)
+
+    make_manifest(args[0], pairs)
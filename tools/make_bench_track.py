@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+Build a bench track bigger than the 64x64 map window, so the bench drives
+the chunk streaming path (track_stream_step) that the shipped 64x48 tracks
+never use.
+
+The source track's map is placed in a larger map, padded with the tile
+in its top-left corner (off-track scenery). Tiles, collision masks and
+properties are copied. Waypoints and gates are shifted by the padding, and the
+progress field is rebuilt for the new world size.
+
+Outputs in <out_dir>: map.bin, tiles.bin, collision.bin, properties.bin,
+waypoints.json/.bin, checkpoints.json/.bin, progress.bin
+
+Usage: ./make_bench_track.py <track_dir> <out_dir> [--size 72 72] [--offset 8 8]
+Normally run by bench/CMakeLists.txt.
+"""
+
+import sys
+import os
+import json
+import shutil
+import argparse
+
+from pack_waypoints import pack_waypoints
+from make_checkpoints import pack_gates
+from make_progress_field import make_progress_field
+
+TILE_PX = 8
+CHUNK_TILES = 8       # MAP_CHUNK_TILES in track.h
+MAX_TILES = 128       # TRACK_MAX_TILES in track.h
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pad a track into a map bigger than the window")
+    parser.add_argument("track_dir", help="Source track (e.g. tracks/track01)")
+    parser.add_argument("out_dir", help="Output directory")
+    parser.add_argument("--width", type=int, default=64, help="Source map width in tiles")
+    parser.add_argument("--size", type=int, nargs=2, default=[72, 72], metavar=("W", "H"),
+                        help="Output map size in tiles")
+    parser.add_argument("--offset", type=int, nargs=2, default=[8, 8], metavar=("X", "Y"),
+                        help="Where the source map goes, in tiles")
+    args = parser.parse_args()
+
+    src_map = open(os.path.join(args.track_dir, "map.bin"), 'rb').read()
+    src_w = args.width
+    src_h = len(src_map) // src_w
+    out_w, out_h = args.size
+    ox, oy = args.offset
+
+    if out_w % CHUNK_TILES or out_h % CHUNK_TILES or max(out_w, out_h) > MAX_TILES:
+        print(f"Error: Size must be multiples of {CHUNK_TILES} up to {MAX_TILES} tiles")
+        sys.exit(1)
+    if ox + src_w > out_w or oy + src_h > out_h:
+        print(f"Error: {src_w}x{src_h} map at {ox},{oy} doesn't fit in {out_w}x{out_h}")
+        sys.exit(1)
+
+    os.makedirs(args.out_dir, exist_ok=True)
+
+    out_map = bytearray([src_map[0]]) * (out_w * out_h)
+    for y in range(src_h):
+        row = src_map[y * src_w:(y + 1) * src_w]
+        start = (oy + y) * out_w + ox
+        out_map[start:start + src_w] = row
+    with open(os.path.join(args.out_dir, "map.bin"), 'wb') as f:
+        f.write(out_map)
+    print(f"Wrote {out_w}x{out_h} map ({src_w}x{src_h} at {ox},{oy})")
+
+    for name in ("tiles.bin", "collision.bin", "properties.bin"):
+        shutil.copyfile(os.path.join(args.track_dir, name), os.path.join(args.out_dir, name))
+
+    dx, dy = ox * TILE_PX, oy * TILE_PX
+
+    with open(os.path.join(args.track_dir, "waypoints.json")) as f:
+        waypoints = [[x + dx, y + dy] for x, y in json.load(f)]
+    waypoints_json = os.path.join(args.out_dir, "waypoints.json")
+    with open(waypoints_json, 'w') as f:
+        json.dump(waypoints, f)
+    pack_waypoints(waypoints_json, os.path.join(args.out_dir, "waypoints.bin"))
+
+    with open(os.path.join(args.track_dir, "checkpoints.json")) as f:
+        gates = [[x1 + dx, y1 + dy, x2 + dx, y2 + dy] for x1, y1, x2, y2 in json.load(f)]
+    with open(os.path.join(args.out_dir, "checkpoints.json"), 'w') as f:
+        json.dump(gates, f)
+    pack_gates(gates, os.path.join(args.out_dir, "checkpoints.bin"))
+
+    make_progress_field(waypoints_json, os.path.join(args.out_dir, "progress.bin"),
+                        out_w * TILE_PX, out_h * TILE_PX)
+
+
+if __name__ == "__main__":
+    main()
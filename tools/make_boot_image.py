@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+Build the boot-time XRAM state so init_graphics() doesn't have to write it.
+
+Two images, both loaded into XRAM by the ROM loader (numeric rp6502_asset):
+- boot_xram.bin at BOOT_IMAGE_ADDR (constants.h): tag, track and text plane
+  configs, car sprite configs and the text plane cleared to spaces
+- boot_palette.bin at PALETTE_ADDR: the 16-colour track palette
+
+Image layout (little endian, offsets must match constants.h):
+    0x0000  tag: 'R', 'M', BOOT_IMAGE_VERSION, car count
+    0x0004  vga_mode2_config_t  track plane (map/tile pointers set per track)
+    0x0014  vga_mode1_config_t  text plane
+    0x0024  vga_mode4_asprite_t x BOOT_MAX_CARS  car sprites
+    0x00C4  text RAM, 3 bytes per char: ' ', HUD_COL_WHITE, HUD_COL_BG
+
+The game checks the tag at boot, so an image built for another car count
+(NUM_AI_CARS) or layout version is reported instead of drawn.
+
+Usage: ./make_boot_image.py <boot_xram.bin> <boot_palette.bin> [--cars N] [--addr A]
+Normally run by CMake, with NUM_CARS and BOOT_IMAGE_ADDR from its cache.
+"""
+
+import sys
+import argparse
+import struct
+
+BOOT_IMAGE_VERSION = 1   # Must match constants.h
+BOOT_MAX_CARS = 8
+TAG_SIZE = 4
+MODE2_CONFIG_SIZE = 16
+MODE1_CONFIG_SIZE = 16
+ASPRITE_SIZE = 20
+BOOT_IMAGE_SIZE = 0x0ED7
+
+PALETTE_ADDR = 0xFF58
+REDRACER_DATA = 0x0000   # Car sprites, loaded by the ROM loader
+CAR_SPRITE_BYTES = 0x200 # 16x16 at 16bpp
+
+MESSAGE_WIDTH = 40       # hud.h
+MESSAGE_HEIGHT = 30
+MESSAGE_LENGTH = MESSAGE_WIDTH * MESSAGE_HEIGHT + 1
+HUD_COL_WHITE = 15
+HUD_COL_BG = 0
+
+# Track palette, RGB555 with the opaque bit (0x0020). Index 0 is transparent.
+TILE_PALETTE = [
+    0x0000, 0x0020, 0x41A7, 0x1AE0, 0x72AA, 0x0038, 0x003E, 0x0372,
+    0x2C60, 0x35AE, 0x053C, 0x073E, 0x93AE, 0xC4B4, 0xD534, 0xF7BE,
+]
+
+# Same start as the old runtime setup: 260,60 centred, clamped to the map
+TRACK_START_X = 100
+TRACK_START_Y = 0
+
+
+def mode2_config(x, y):
+    # x_wrap, y_wrap, x_pos_px, y_pos_px, width_tiles, height_tiles,
+    # xram_data_ptr, xram_palette_ptr, xram_tile_ptr
+    return struct.pack("<BBhhhhHHH", 0, 0, x, y, 0, 0, 0, PALETTE_ADDR, 0)
+
+
+def mode1_config(text_addr):
+    # x_wrap, y_wrap, x_pos_px, y_pos_px, width_chars, height_chars,
+    # xram_data_ptr, xram_palette_ptr, xram_font_ptr
+    # x_pos_px stays 0: the first char is duplicated otherwise
+    return struct.pack("<BBhhhhHHH", 0, 0, 0, 5, MESSAGE_WIDTH, MESSAGE_HEIGHT,
+                       text_addr, 0xFFFF, 0xFFFF)
+
+
+def sprite_config(slot):
+    # Identity transform; the first frame moves every car into place.
+    # Fields over 4 cars reuse the 4 liveries.
+    ptr = REDRACER_DATA + (slot & 3) * CAR_SPRITE_BYTES
+    x = y = 0 if slot == 0 else 100 + (slot - 1) * 20
+    return struct.pack("<6hhhHBB", 256, 0, 0, 0, 256, 0, x, y, ptr, 4, 0)
+
+
+def build_image(image_addr, cars):
+    text_addr = image_addr + TAG_SIZE + MODE2_CONFIG_SIZE + MODE1_CONFIG_SIZE + \
+        ASPRITE_SIZE * BOOT_MAX_CARS
+
+    image = bytearray(b"RM" + bytes([BOOT_IMAGE_VERSION, cars]))
+    image += mode2_config(TRACK_START_X, TRACK_START_Y)
+    image += mode1_config(text_addr)
+    for slot in range(BOOT_MAX_CARS):
+        image += sprite_config(slot) if slot < cars else bytes(ASPRITE_SIZE)
+    image += bytes([ord(' '), HUD_COL_WHITE, HUD_COL_BG]) * MESSAGE_LENGTH
+
+    if len(image) != BOOT_IMAGE_SIZE:
+        print(f"Error: Boot image is {len(image)} bytes, constants.h expects {BOOT_IMAGE_SIZE}")
+        sys.exit(1)
+    return image
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Build the boot XRAM image and palette")
+    parser.add_argument("image", help="Output boot_xram.bin")
+    parser.add_argument("palette", help="Output boot_palette.bin")
+    parser.add_argument("--cars", type=int, default=4, help="NUM_CARS the game is built with")
+    parser.add_argument("--addr", type=lambda s: int(s, 0), default=0x0800,
+                        help="XRAM address of the image (BOOT_IMAGE_ADDR)")
+    args = parser.parse_args()
+
+    if not 1 <= args.cars <= BOOT_MAX_CARS:
+        print(f"Error: --cars must be 1..{BOOT_MAX_CARS}")
+        sys.exit(1)
+
+    image = build_image(args.addr, args.cars)
+    with open(args.image, 'wb') as f:
+        f.write(image)
+    print(f"Wrote {len(image)} bytes to {args.image}")
+
+    with open(args.palette, 'wb') as f:
+        f.write(struct.pack(f"<{len(TILE_PALETTE)}H", *TILE_PALETTE))
+    print(f"Wrote {2 * len(TILE_PALETTE)} bytes to {args.palette}")
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""
+Build the finish line and checkpoint gates for a track.
+
+Gates are line segments in world pixels. Gate 0 is the finish line, gates
+1..N-1 are checkpoints that must be crossed in order. Each gate is oriented
+so a car driving forward goes from the negative to the positive side of
+    side = (x2 - x1) * (py - y1) - (y2 - y1) * (px - x1)
+which is what update_lap_logic() tests.
+
+Source format (checkpoints.json):
+    [[x1, y1, x2, y2], ...]   # finish line first
+
+Output format (checkpoints.bin, little endian):
+- uint8 gate_count
+- int16 x1, y1, x2, y2 per gate
+
+Usage:
+    ./make_checkpoints.py <track_dir>           # pack checkpoints.json
+    ./make_checkpoints.py --auto <track_dir>    # regenerate json, then pack
+
+--auto places the finish line along the finish-line tiles and one
+checkpoint at 1/4, 1/2 and 3/4 of the waypoint loop, spanning wall to wall.
+"""
+
+import sys
+import os
+import json
+import math
+import struct
+import argparse
+
+MAX_GATES = 8           # Must match MAX_GATES in track.h
+MAX_GATE_LENGTH = 96    # Keeps the runtime side test inside int16
+GATE_HALF_SPAN = 48     # Max search distance from a waypoint to a wall
+
+TERRAIN_WALL = 2
+
+# Finish-line tile IDs per tileset (must match process_track.py)
+CLASSIC_FINISH_TILES = set(range(243, 249))
+TRACK03_FINISH_TILES = {14, 15, 44, 45}
+
+
+class TrackData:
+    def __init__(self, track_dir, width_tiles=64):
+        with open(os.path.join(track_dir, "map.bin"), 'rb') as f:
+            self.world_map = f.read()
+        self.width_tiles = width_tiles
+        self.width_px = width_tiles * 8
+        self.height_px = (len(self.world_map) // width_tiles) * 8
+        with open(os.path.join(track_dir, "collision.bin"), 'rb') as f:
+            self.collision = f.read()
+        with open(os.path.join(track_dir, "properties.bin"), 'rb') as f:
+            self.properties = f.read()
+        with open(os.path.join(track_dir, "waypoints.json"), 'r') as f:
+            self.waypoints = json.load(f)
+
+    def tile_at(self, tx, ty):
+        return self.world_map[ty * self.width_tiles + tx]
+
+    def is_wall(self, x, y):
+        # Mirrors get_terrain_at() in track.c
+        if x < 0 or y < 0 or x >= self.width_px or y >= self.height_px:
+            return True
+        tile_id = self.tile_at(x >> 3, y >> 3)
+        offset = tile_id * 8 + (y & 7)
+        row_mask = self.collision[offset] if offset < len(self.collision) else 0
+        if row_mask & (0x80 >> (x & 7)):
+            return True
+        prop = self.properties[tile_id] if tile_id < len(self.properties) else TERRAIN_WALL
+        return (prop & 0x03) == TERRAIN_WALL  # Low bits: surface; trigger bits above
+
+
+def loop_direction_at(waypoints, px, py):
+    """Direction of travel on the waypoint loop nearest to (px, py)."""
+    best = None
+    for i in range(len(waypoints)):
+        ax, ay = waypoints[i]
+        bx, by = waypoints[(i + 1) % len(waypoints)]
+        sx, sy = bx - ax, by - ay
+        seg_len_sq = sx * sx + sy * sy
+        t = 0.0
+        if seg_len_sq > 0:
+            t = max(0.0, min(1.0, ((px - ax) * sx + (py - ay) * sy) / seg_len_sq))
+        d = (px - ax - sx * t) ** 2 + (py - ay - sy * t) ** 2
+        if best is None or d < best[0]:
+            best = (d, sx, sy)
+    return best[1], best[2]
+
+
+def orient(gate, dx, dy):
+    """Swap endpoints so driving along (dx, dy) crosses from - to +."""
+    x1, y1, x2, y2 = gate
+    if (x2 - x1) * dy - (y2 - y1) * dx < 0:
+        return [x2, y2, x1, y1]
+    return gate
+
+
+def finish_gate(track, finish_tiles):
+    w = track.width_tiles
+    cells = [(i % w, i // w) for i, t in enumerate(track.world_map) if t in finish_tiles]
+    if not cells:
+        return None
+
+    # The finish strip is the column (or row) holding the most finish tiles
+    cols = {}
+    rows = {}
+    for tx, ty in cells:
+        cols.setdefault(tx, []).append(ty)
+        rows.setdefault(ty, []).append(tx)
+    best_col = max(cols, key=lambda c: len(cols[c]))
+    best_row = max(rows, key=lambda r: len(rows[r]))
+
+    if len(cols[best_col]) >= len(rows[best_row]):
+        strip = [c for c in cols if abs(c - best_col) <= 1 and len(cols[c]) * 2 >= len(cols[best_col])]
+        run = sorted(cols[best_col])
+        x = (min(strip) + max(strip) + 1) * 4  # Centre of the strip in pixels
+        gate = [x, run[0] * 8, x, (run[-1] + 1) * 8]
+    else:
+        strip = [r for r in rows if abs(r - best_row) <= 1 and len(rows[r]) * 2 >= len(rows[best_row])]
+        run = sorted(rows[best_row])
+        y = (min(strip) + max(strip) + 1) * 4
+        gate = [run[0] * 8, y, (run[-1] + 1) * 8, y]
+
+    cx = (gate[0] + gate[2]) // 2
+    cy = (gate[1] + gate[3]) // 2
+    dx, dy = loop_direction_at(track.waypoints, cx, cy)
+    return orient(gate, dx, dy)
+
+
+def checkpoint_gate(track, index):
+    wps = track.waypoints
+    count = len(wps)
+    px, py = wps[index]
+    nx, ny = wps[(index + 1) % count]
+    bx, by = wps[(index - 1) % count]
+    dx, dy = nx - bx, ny - by
+    length = math.hypot(dx, dy)
+    if length == 0:
+        return None
+
+    # Perpendicular to the direction of travel
+    ux, uy = -dy / length, dx / length
+
+    def reach(sign):
+        last = (px, py)
+        for step in range(1, GATE_HALF_SPAN + 1):
+            x = int(round(px + ux * step * sign))
+            y = int(round(py + uy * step * sign))
+            if track.is_wall(x, y):
+                break
+            last = (x, y)
+        return last
+
+    a = reach(-1)
+    b = reach(1)
+    return orient([a[0], a[1], b[0], b[1]], dx, dy)
+
+
+def auto_gates(track, finish_tiles):
+    gates = []
+    finish = finish_gate(track, finish_tiles)
+    if finish is None:
+        print("Error: No finish-line tiles found in map.bin")
+        sys.exit(1)
+    gates.append(finish)
+
+    total = len(track.waypoints)
+    for index in (total // 4, total // 2, total * 3 // 4):
+        gate = checkpoint_gate(track, index)
+        if gate is not None:
+            gates.append(gate)
+    return gates
+
+
+def pack_gates(gates, output_file):
+    if not 1 <= len(gates) <= MAX_GATES:
+        print(f"Error: Need 1..{MAX_GATES} gates, got {len(gates)}")
+        sys.exit(1)
+
+    with open(output_file, 'wb') as f:
+        f.write(struct.pack('<B', len(gates)))
+        for gate in gates:
+            x1, y1, x2, y2 = gate
+            if max(abs(x2 - x1), abs(y2 - y1)) > MAX_GATE_LENGTH:
+                print(f"Error: Gate {gate} is longer than {MAX_GATE_LENGTH}px")
+                sys.exit(1)
+            f.write(struct.pack('<hhhh', x1, y1, x2, y2))
+
+    print(f"Wrote {len(gates)} gates to {output_file}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build finish line and checkpoint gates.")
+    parser.add_argument("track_dir", help="Track directory (e.g. tracks/track01)")
+    parser.add_argument("--auto", action="store_true", help="Regenerate checkpoints.json from the map and waypoints")
+    parser.add_argument("--finish-tiles", default="classic", choices=["classic", "track03"],
+                        help="Finish-line tile set used by --auto")
+    parser.add_argument("--width", type=int, default=64, help="Map width in tiles (height follows from map.bin)")
+    args = parser.parse_args()
+
+    json_path = os.path.join(args.track_dir, "checkpoints.json")
+    bin_path = os.path.join(args.track_dir, "checkpoints.bin")
+
+    if args.auto:
+        finish_tiles = CLASSIC_FINISH_TILES if args.finish_tiles == "classic" else TRACK03_FINISH_TILES
+        gates = auto_gates(TrackData(args.track_dir, args.width), finish_tiles)
+        with open(json_path, 'w') as f:
+            json.dump(gates, f)
+        print(f"Wrote {json_path}")
+
+    with open(json_path, 'r') as f:
+        gates = json.load(f)
+    pack_gates(gates, bin_path)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+Generate the track progress field from the AI waypoints.
+
+The world (512x384 px by default) is split into 16x16 px cells, doubled
+in size until the field fits in 1024 cells (the same rule as
+set_world_size() in track.c). Each cell stores the distance along the
+waypoint loop (in pixels, measured from waypoint 0) of the closest point
+on the loop. At runtime a car's race progress is one table read at its
+centre, so race order needs no radius checks.
+
+Output format (little endian):
+- uint16 lap_length            (pixels around the full loop)
+- uint16 field[H][W]           (0 .. lap_length-1, row major; 24x32 by default)
+
+Usage: ./make_progress_field.py <waypoints.json> <progress.bin> [width_px height_px]
+"""
+
+import sys
+import os
+import json
+import math
+import struct
+
+MIN_CELL_SHIFT = 4    # Must match PROGRESS_MIN_CELL_SHIFT in track.h
+FIELD_CELLS = 1024    # Must match PROGRESS_FIELD_CELLS in track.h
+
+
+def cell_shift_for(world_width, world_height):
+    shift = MIN_CELL_SHIFT
+    while (world_width >> shift) * (world_height >> shift) > FIELD_CELLS:
+        shift += 1
+    return shift
+
+
+def project_onto_loop(px, py, waypoints, seg_start):
+    """Return the loop distance of the point on the loop closest to (px, py)."""
+    best_dist = None
+    best_progress = 0.0
+    count = len(waypoints)
+
+    for i in range(count):
+        ax, ay = waypoints[i]
+        bx, by = waypoints[(i + 1) % count]
+        sx, sy = bx - ax, by - ay
+        seg_len_sq = sx * sx + sy * sy
+
+        t = 0.0
+        if seg_len_sq > 0:
+            t = ((px - ax) * sx + (py - ay) * sy) / seg_len_sq
+            t = max(0.0, min(1.0, t))
+
+        qx, qy = ax + sx * t, ay + sy * t
+        d = (px - qx) ** 2 + (py - qy) ** 2
+
+        if best_dist is None or d < best_dist:
+            best_dist = d
+            best_progress = seg_start[i] + t * math.sqrt(seg_len_sq)
+
+    return best_progress
+
+
+def make_progress_field(input_file, output_file, world_width=512, world_height=384):
+    cell_size = 1 << cell_shift_for(world_width, world_height)
+    field_width = world_width // cell_size
+    field_height = world_height // cell_size
+
+    with open(input_file, 'r') as f:
+        waypoints = json.load(f)
+
+    if len(waypoints) < 2:
+        print(f"Error: {input_file} needs at least 2 waypoints")
+        sys.exit(1)
+
+    # Cumulative loop distance at the start of each segment
+    seg_start = []
+    lap_length = 0.0
+    for i in range(len(waypoints)):
+        ax, ay = waypoints[i]
+        bx, by = waypoints[(i + 1) % len(waypoints)]
+        seg_start.append(lap_length)
+        lap_length += math.hypot(bx - ax, by - ay)
+
+    lap_length_px = int(round(lap_length))
+    if lap_length_px * 5 > 32767:
+        print(f"WARNING: Lap length {lap_length_px}px overflows int16 race progress over 5 laps")
+
+    field = []
+    for cy in range(field_height):
+        for cx in range(field_width):
+            px = cx * cell_size + cell_size // 2
+            py = cy * cell_size + cell_size // 2
+            progress = int(project_onto_loop(px, py, waypoints, seg_start))
+            field.append(progress % lap_length_px)
+
+    with open(output_file, 'wb') as f:
+        f.write(struct.pack('<H', lap_length_px))
+        f.write(struct.pack(f'<{len(field)}H', *field))
+
+    print(f"Wrote {field_width}x{field_height} progress field (lap {lap_length_px}px) to {output_file}")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) not in (3, 5):
+        print(f"Usage: {sys.argv[0]} <waypoints.json> <progress.bin> [width_px height_px]")
+        sys.exit(1)
+
+    if not os.path.exists(sys.argv[1]):
+        print(f"Error: File not found: {sys.argv[1]}")
+        sys.exit(1)
+
+    if len(sys.argv) == 5:
+        make_progress_field(sys.argv[1], sys.argv[2], int(sys.argv[3]), int(sys.argv[4]))
+    else:
+        make_progress_field(sys.argv[1], sys.argv[2])
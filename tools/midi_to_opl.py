@@ -0,0 +1,476 @@
+#!/usr/bin/env python3
+"""
+Compile a standard MIDI file into an OPL2 register stream for update_music().
+
+Instruments come from gm_bank (and the drum_* patches) in src/instruments.c,
+so the song sounds the same as anything played through OPL_SetPatch().
+Every 60 Hz tick is limited to a fixed number of register writes. Patch
+loads are moved into earlier quiet ticks on the channel they will play on,
+and anything that still doesn't fit slips to the next tick, so no tick of
+music costs more than the budget however dense the MIDI is.
+
+Output format (same as DEMO.BIN, little endian, 4 bytes per packet):
+- uint8  reg
+- uint8  value
+- uint16 delay      (ticks to wait after this write; 0 = same tick)
+The stream ends with the loop marker 0xFF 0xFF.
+
+With --events it writes a note-level song for song_play() in sequencer.c
+instead (SongEvent in opl.h, 6 bytes per event, little endian):
+- uint16 delay_ms   (since the previous event)
+- uint8  type       (0 note off, 1 note on, 2 wait, 3 patch, 0xFF end)
+- uint8  channel    (OPL channel, already allocated)
+- uint8  note       (MIDI note; for patch events the program, 128+ = drums)
+- uint8  velocity
+
+Usage: ./midi_to_opl.py <song.mid> <song.bin> [--max-writes N] [--channels N]
+                        [--events] [--instruments path/to/instruments.c]
+"""
+
+import sys
+import os
+import re
+import struct
+import argparse
+
+TICK_HZ = 60
+OPL_CHANNELS = 9
+DRUM_MIDI_CHANNEL = 9
+DRUM_PITCH = 60  # OPL_NoteOn() plays drums at middle C
+
+MOD_OFFSETS = [0x00, 0x01, 0x02, 0x08, 0x09, 0x0A, 0x10, 0x11, 0x12]
+CAR_OFFSETS = [0x03, 0x04, 0x05, 0x0B, 0x0C, 0x0D, 0x13, 0x14, 0x15]
+FNUM_TABLE = [308, 325, 345, 365, 387, 410, 434, 460, 487, 516, 547, 579]  # opl.c
+
+PATCH_FIELDS = ['m_ave', 'm_ksl', 'm_atdec', 'm_susrel', 'm_wave',
+                'c_ave', 'c_ksl', 'c_atdec', 'c_susrel', 'c_wave', 'feedback']
+
+DEFAULT_INSTRUMENTS = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                   '..', 'src', 'instruments.c')
+
+
+# --- Instruments ---
+
+def parse_patch(body):
+    fields = dict(re.findall(r'\.(\w+)\s*=\s*(0x[0-9A-Fa-f]+|\d+)', body))
+    return tuple(int(fields.get(name, '0'), 0) for name in PATCH_FIELDS)
+
+
+def load_instruments(path):
+    """Returns (gm_bank dict program -> patch, drums dict name -> patch)."""
+    with open(path) as f:
+        src = f.read()
+
+    bank_start = src.index('{', src.index('gm_bank['))
+    bank_end = src.index('};', bank_start)
+    bank = {int(num): parse_patch(body) for num, body in
+            re.findall(r'\[(\d+)\]\s*=\s*\{([^}]*)\}', src[bank_start:bank_end])}
+
+    drums = {name: parse_patch(body) for name, body in
+             re.findall(r'OPL_Patch\s+(drum_\w+)\s*=\s*\{([^}]*)\}', src)}
+    return bank, drums
+
+
+# SONG_DRUM_* in opl.h
+DRUM_PROGRAMS = {'drum_bd': 128, 'drum_snare': 129, 'drum_hihat': 130}
+
+SONG_NOTE_OFF, SONG_NOTE_ON, SONG_WAIT, SONG_PATCH, SONG_END = 0, 1, 2, 3, 0xFF
+
+
+def drum_name(note):
+    if note in (35, 36):
+        return 'drum_bd'
+    if note in (37, 38, 39, 40):
+        return 'drum_snare'
+    return 'drum_hihat'
+
+
+def drum_patch(drums, note):
+    return drums[drum_name(note)]
+
+
+def patch_writes(ch, p):
+    """Same registers, in the same order, as OPL_SetPatch()."""
+    m, c = MOD_OFFSETS[ch], CAR_OFFSETS[ch]
+    return [(0x20 + m, p[0]), (0x20 + c, p[5]),
+            (0x40 + m, p[1]), (0x40 + c, p[6]),
+            (0x60 + m, p[2]), (0x60 + c, p[7]),
+            (0x80 + m, p[3]), (0x80 + c, p[8]),
+            (0xE0 + m, p[4]), (0xE0 + c, p[9]),
+            (0xC0 + ch, p[10])]
+
+
+def note_freq(note):
+    """(A0 value, B0 value without key-on), as midi_to_opl_freq() in opl.c."""
+    note = max(note, 12)
+    block = min((note - 12) // 12, 7)
+    fnum = FNUM_TABLE[(note - 12) % 12]
+    return fnum & 0xFF, (block << 2) | ((fnum >> 8) & 0x03)
+
+
+def carrier_level(patch, velocity):
+    """Carrier KSL/TL scaled by velocity (quieter notes get more attenuation)."""
+    tl = patch[6] & 0x3F
+    tl = min(63, tl + ((127 - velocity) >> 2))
+    return (patch[6] & 0xC0) | tl
+
+
+# --- MIDI ---
+
+def read_varlen(data, pos):
+    value = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value = (value << 7) | (b & 0x7F)
+        if not b & 0x80:
+            return value, pos
+
+
+def parse_midi(path):
+    """Returns a time-sorted list of (seconds, kind, channel, a, b)."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data[:4] != b'MThd':
+        raise ValueError(f"{path} is not a standard MIDI file")
+    hdr_len, fmt, ntracks, division = struct.unpack('>IHHH', data[4:14])
+    if division & 0x8000:
+        raise ValueError("SMPTE time division is not supported")
+
+    pos = 8 + hdr_len
+    raw = []    # (midi_tick, order, kind, channel, a, b)
+    tempos = [(0, 500000)]
+    order = 0
+    for _ in range(ntracks):
+        if data[pos:pos + 4] != b'MTrk':
+            raise ValueError("Bad track chunk")
+        length = struct.unpack('>I', data[pos + 4:pos + 8])[0]
+        pos += 8
+        end = pos + length
+        tick = 0
+        status = 0
+        while pos < end:
+            delta, pos = read_varlen(data, pos)
+            tick += delta
+            b = data[pos]
+            if b & 0x80:
+                status = b
+                pos += 1
+            if status == 0xFF:
+                meta = data[pos]
+                mlen, pos = read_varlen(data, pos + 1)
+                if meta == 0x51 and mlen == 3:
+                    tempos.append((tick, int.from_bytes(data[pos:pos + 3], 'big')))
+                pos += mlen
+                status = 0
+            elif status in (0xF0, 0xF7):
+                slen, pos = read_varlen(data, pos)
+                pos += slen
+                status = 0
+            else:
+                kind = status & 0xF0
+                chan = status & 0x0F
+                a = data[pos]
+                nbytes = 1 if kind in (0xC0, 0xD0) else 2
+                bval = data[pos + 1] if nbytes == 2 else 0
+                pos += nbytes
+                if kind == 0x90 and bval == 0:
+                    kind = 0x80
+                if kind in (0x80, 0x90, 0xC0):
+                    raw.append((tick, order, kind, chan, a, bval))
+                    order += 1
+        pos = end
+
+    # MIDI ticks -> seconds through the tempo map
+    tempos.sort()
+    raw.sort(key=lambda e: (e[0], e[2] != 0x80, e[1]))  # Note-offs first on a tie
+    events = []
+    t_idx, t_tick, t_sec, us_per_q = 0, 0, 0.0, tempos[0][1]
+    for tick, _, kind, chan, a, bval in raw:
+        while t_idx + 1 < len(tempos) and tempos[t_idx + 1][0] <= tick:
+            t_idx += 1
+            t_sec += (tempos[t_idx][0] - t_tick) * us_per_q / 1e6 / division
+            t_tick = tempos[t_idx][0]
+            us_per_q = tempos[t_idx][1]
+        seconds = t_sec + (tick - t_tick) * us_per_q / 1e6 / division
+        events.append((seconds, kind, chan, a, bval))
+    return events
+
+
+# --- Voice allocation ---
+
+class Job:
+    """A group of register writes for one channel, done in order."""
+    def __init__(self, ch, frame, writes, deadline=None, after=None):
+        self.ch = ch
+        self.frame = frame        # Earliest tick it may run
+        self.deadline = deadline  # Patch loads: tick of the note that needs it
+        self.writes = writes
+        self.after = after        # Job that must finish first
+
+    @property
+    def done(self):
+        return not self.writes
+
+
+def allocate(events, bank, drums, channels):
+    """Assign notes to OPL channels. Returns the list of Jobs."""
+    jobs = []
+    free_at = [0] * channels        # Tick of the channel's last key-off
+    playing = [None] * channels     # (midi_chan, note, pitch) or None
+    started = [0] * channels
+    loaded = [None] * channels      # Patch the channel will hold
+    last_job = [None] * channels
+    program = [0] * 16
+
+    def key_off(ch, frame):
+        _, b0 = note_freq(playing[ch][2])
+        job = Job(ch, frame, [(0xB0 + ch, b0)], after=last_job[ch])
+        jobs.append(job)
+        last_job[ch] = job
+        playing[ch] = None
+        free_at[ch] = frame
+
+    for seconds, kind, chan, a, b in events:
+        frame = int(round(seconds * TICK_HZ))
+        if kind == 0xC0:
+            program[chan] = a
+            continue
+
+        if kind == 0x80:
+            for ch in range(channels):
+                if playing[ch] and playing[ch][:2] == (chan, a):
+                    key_off(ch, frame)
+                    break
+            continue
+
+        # Note on
+        if chan == DRUM_MIDI_CHANNEL:
+            patch = drum_patch(drums, a)
+            pitch = DRUM_PITCH
+        else:
+            patch = bank.get(program[chan], bank[0])
+            pitch = a
+
+        idle = [ch for ch in range(channels) if playing[ch] is None]
+        if idle:
+            # Prefer a channel that already has the patch, then the longest idle
+            same = [ch for ch in idle if loaded[ch] == patch]
+            ch = same[0] if same else min(idle, key=lambda c: free_at[c])
+        else:
+            ch = min(range(channels), key=lambda c: started[c])  # Steal the oldest
+            key_off(ch, frame)
+
+        if loaded[ch] != patch:
+            # Any tick after the previous note released will do
+            window_start = free_at[ch] + 1 if last_job[ch] else 0
+            pj = Job(ch, min(window_start, frame), patch_writes(ch, patch),
+                     deadline=frame, after=last_job[ch])
+            jobs.append(pj)
+            last_job[ch] = pj
+            loaded[ch] = patch
+
+        a0, b0 = note_freq(pitch)
+        on = Job(ch, frame, [(0x40 + CAR_OFFSETS[ch], carrier_level(patch, b)),
+                             (0xA0 + ch, a0), (0xB0 + ch, 0x20 | b0)], after=last_job[ch])
+        jobs.append(on)
+        last_job[ch] = on
+        playing[ch] = (chan, a, pitch)
+        started[ch] = frame
+
+    # Release anything still held at the end
+    end = max((j.frame for j in jobs), default=0) + 1
+    for ch in range(channels):
+        if playing[ch]:
+            key_off(ch, end)
+    return jobs
+
+
+def compile_events(events, channels):
+    """Note-level version of allocate(): SongEvent tuples (ms, type, ch, note, vel)."""
+    out = []
+    free_at = [0] * channels
+    playing = [None] * channels     # (midi_chan, note) or None
+    started = [0] * channels
+    loaded = [None] * channels      # Program (or drum program) on the channel
+    program = [0] * 16
+
+    for seconds, kind, chan, a, b in events:
+        ms = int(round(seconds * 1000))
+        if kind == 0xC0:
+            program[chan] = a
+            continue
+
+        if kind == 0x80:
+            for ch in range(channels):
+                if playing[ch] == (chan, a):
+                    out.append((ms, SONG_NOTE_OFF, ch, 0, 0))
+                    playing[ch] = None
+                    free_at[ch] = ms
+                    break
+            continue
+
+        prog = DRUM_PROGRAMS[drum_name(a)] if chan == DRUM_MIDI_CHANNEL else program[chan]
+        idle = [ch for ch in range(channels) if playing[ch] is None]
+        if idle:
+            same = [ch for ch in idle if loaded[ch] == prog]
+            ch = same[0] if same else min(idle, key=lambda c: free_at[c])
+        else:
+            ch = min(range(channels), key=lambda c: started[c])
+            out.append((ms, SONG_NOTE_OFF, ch, 0, 0))
+
+        if loaded[ch] != prog:
+            out.append((ms, SONG_PATCH, ch, prog, 0))
+            loaded[ch] = prog
+        out.append((ms, SONG_NOTE_ON, ch, a, b))
+        playing[ch] = (chan, a)
+        started[ch] = ms
+
+    end = out[-1][0] if out else 0
+    for ch in range(channels):
+        if playing[ch]:
+            out.append((end, SONG_NOTE_OFF, ch, 0, 0))
+    out.append((end, SONG_END, 0, 0, 0))
+    return out
+
+
+def write_events(output_file, song):
+    data = bytearray()
+    prev = 0
+    for ms, kind, ch, note, vel in song:
+        delay = ms - prev
+        while delay > 0xFFFF:
+            data += struct.pack('<HBBBB', 0xFFFF, SONG_WAIT, 0, 0, 0)
+            delay -= 0xFFFF
+        data += struct.pack('<HBBBB', delay, kind, ch, note, vel)
+        prev = ms
+    with open(output_file, 'wb') as f:
+        f.write(data)
+    return len(data)
+
+
+# --- Scheduling under the per-tick budget ---
+
+def schedule(jobs, max_writes, preamble):
+    """Returns {tick: [(reg, val), ...]} with at most max_writes per tick."""
+    ticks = {}
+    shadow = {}
+    pending = list(jobs)
+    late = 0
+    worst_delay = 0
+    frame = 0
+
+    out = ticks.setdefault(0, [])
+    for reg, val in preamble:
+        out.append((reg, val))
+        shadow[reg] = val
+
+    while pending:
+        budget = max_writes - len(ticks.get(frame, []))
+        progress = True
+        while progress and budget > 0:
+            # Timed writes first (key-on/off at their own tick), in order.
+            # Then patch loads with the nearest deadline. A finished job can
+            # unblock the next one on its channel within the same tick.
+            progress = False
+            ready = [j for j in pending
+                     if j.frame <= frame and (j.after is None or j.after.done)]
+            ready.sort(key=lambda j: (j.deadline is not None,
+                                      j.deadline if j.deadline is not None else j.frame))
+            for job in ready:
+                while job.writes and budget > 0:
+                    reg, val = job.writes.pop(0)
+                    progress = True
+                    if shadow.get(reg) == val:
+                        continue  # Already holds that value
+                    ticks.setdefault(frame, []).append((reg, val))
+                    shadow[reg] = val
+                    budget -= 1
+                if job.done:
+                    due = job.deadline if job.deadline is not None else job.frame
+                    if frame > due:
+                        late += 1
+                        worst_delay = max(worst_delay, frame - due)
+            pending = [j for j in pending if not j.done]
+        frame += 1
+
+    return ticks, late, worst_delay
+
+
+def build_stream(ticks):
+    frames = sorted(f for f in ticks if ticks[f])
+    packets = bytearray()
+    for i, f in enumerate(frames):
+        nxt = frames[i + 1] if i + 1 < len(frames) else f + 1
+        writes = ticks[f]
+        for j, (reg, val) in enumerate(writes):
+            delay = (nxt - f) if j == len(writes) - 1 else 0
+            # Very long rests: pad with writes to an unused register
+            while delay > 0xFFFF:
+                packets += struct.pack('<BBH', reg, val, 0xFFFF)
+                reg, val = 0x08, 0x00
+                delay -= 0xFFFF
+            packets += struct.pack('<BBH', reg, val, delay)
+    packets += struct.pack('<BBH', 0xFF, 0xFF, 1)  # Loop marker
+    return packets
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile MIDI to an OPL2 register stream.")
+    parser.add_argument('midi')
+    parser.add_argument('output')
+    parser.add_argument('--max-writes', type=int, default=8,
+                        help="Register writes allowed per 60 Hz tick (default 8)")
+    parser.add_argument('--channels', type=int, default=8,
+                        help="OPL channels the song may use (default 8, leaving 8 for the engine)")
+    parser.add_argument('--events', action='store_true',
+                        help="Write a note-level SongEvent song instead of registers")
+    parser.add_argument('--instruments', default=DEFAULT_INSTRUMENTS,
+                        help="instruments.c holding gm_bank")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.midi):
+        print(f"Error: File not found: {args.midi}")
+        sys.exit(1)
+    if not 1 <= args.channels <= OPL_CHANNELS:
+        print(f"Error: --channels must be 1-{OPL_CHANNELS}")
+        sys.exit(1)
+    if args.max_writes < 4:
+        print("Error: --max-writes must be at least 4 (one note-on is 3 writes)")
+        sys.exit(1)
+
+    bank, drums = load_instruments(args.instruments)
+    events = parse_midi(args.midi)
+    jobs = allocate(events, bank, drums, args.channels)
+
+    # Same global setup as opl_init()
+    preamble = [(0x01, 0x20), (0xBD, 0x00)]
+    ticks, late, worst_delay = schedule(jobs, args.max_writes, preamble)
+    stream = build_stream(ticks)
+    notes = sum(1 for e in events if e[1] == 0x90)
+
+    if args.events:
+        song = compile_events(events, args.channels)
+        size = write_events(args.output, song)
+        print(f"Wrote {args.output}: {notes} notes, {len(song)} events, {size} bytes "
+              f"({len(stream)} as a register stream, {len(stream) / max(size, 1):.1f}x larger)")
+        return
+
+    with open(args.output, 'wb') as f:
+        f.write(stream)
+    size = len(stream)
+
+    counts = [len(w) for w in ticks.values() if w]
+    length = max(ticks) + 1 if ticks else 0
+    total = sum(counts)
+    print(f"Wrote {args.output}: {notes} notes, {length} ticks ({length / TICK_HZ:.1f}s), {size} bytes")
+    print(f"Writes/tick: peak {max(counts, default=0)} (budget {args.max_writes}), "
+          f"average {total / max(length, 1):.2f} over the song, "
+          f"{total / max(len(counts), 1):.2f} over the {len(counts)} active ticks")
+    if late:
+        print(f"Budget pushed {late} events late (worst {worst_delay} ticks)")
+
+
+if __name__ == "__main__":
+    main()
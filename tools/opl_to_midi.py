@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Turn an OPL2 register stream (DEMO.BIN format, see midi_to_opl.py) back into
+a standard MIDI file, so songs that only exist as register dumps can go
+through midi_to_opl.py --events and play on the note-level sequencer.
+
+Every key-on becomes a note. The pitch is the nearest semitone to the
+channel's Block/F-Number, and the velocity comes back out of the carrier
+level the same way carrier_level() put it in. The instrument is the
+gm_bank program (or drum_* patch) whose registers match what the channel
+holds at the key-on. A patch that isn't in the bank gets the closest one,
+and the tool says so. Drum patches go to MIDI channel 10.
+
+One 60 Hz tick is 16 MIDI ticks (480 per quarter note at 120 BPM).
+
+Usage: ./opl_to_midi.py <song.bin> <song.mid> [--instruments path/to/instruments.c]
+"""
+
+import sys
+import math
+import struct
+import argparse
+
+from midi_to_opl import (load_instruments, DEFAULT_INSTRUMENTS, MOD_OFFSETS,
+                         CAR_OFFSETS, FNUM_TABLE, DRUM_MIDI_CHANNEL, OPL_CHANNELS)
+
+PPQ = 480
+TEMPO = 500000     # us per quarter note
+TICK_MIDI = 16     # MIDI ticks per 60 Hz tick at PPQ and TEMPO
+
+DRUM_NOTES = {'drum_bd': 36, 'drum_snare': 38, 'drum_hihat': 42}
+
+
+def channel_patch(regs, ch):
+    """The channel's patch as a load_instruments() tuple. The carrier's total
+    level carries the velocity, so only its KSL bits are kept."""
+    m, c = MOD_OFFSETS[ch], CAR_OFFSETS[ch]
+    return (regs[0x20 + m], regs[0x40 + m], regs[0x60 + m], regs[0x80 + m], regs[0xE0 + m],
+            regs[0x20 + c], regs[0x40 + c] & 0xC0, regs[0x60 + c], regs[0x80 + c],
+            regs[0xE0 + c], regs[0xC0 + ch])
+
+
+def without_level(patch):
+    return patch[:6] + (patch[6] & 0xC0,) + patch[7:]
+
+
+def match_patch(patch, bank, drums):
+    """Returns (program or drum name, exact)."""
+    for name, p in drums.items():
+        if without_level(p) == patch:
+            return name, True
+    for prog in sorted(bank):
+        if without_level(bank[prog]) == patch:
+            return prog, True
+    prog = min(sorted(bank), key=lambda n: sum(abs(a - b) for a, b in
+                                                 zip(without_level(bank[n]), patch)))
+    return prog, False
+
+
+def opl_note(b0, a0):
+    fnum = ((b0 & 0x03) << 8) | a0
+    block = (b0 >> 2) & 0x07
+    if fnum == 0:
+        return 12
+    semis = round(12 * math.log2(fnum / FNUM_TABLE[0]))
+    return max(0, min(127, 12 + 12 * block + semis))
+
+
+def velocity(patch_tl, carrier_ksl):
+    """Inverse of carrier_level() in midi_to_opl.py."""
+    extra = (carrier_ksl & 0x3F) - (patch_tl & 0x3F)
+    return max(1, min(127, 127 - 4 * extra))
+
+
+def read_stream(path):
+    """Returns [(tick, reg, value)] up to the loop marker."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    writes = []
+    tick = 0
+    for pos in range(0, len(data) - 3, 4):
+        reg, val, delay = struct.unpack_from('<BBH', data, pos)
+        if reg == 0xFF and val == 0xFF:
+            break
+        writes.append((tick, reg, val))
+        tick += delay
+    return writes, tick
+
+
+def convert(writes, bank, drums):
+    """Returns ([(tick, order, status, a, b)], unmatched patches)."""
+    regs = [0] * 256
+    sounding = [None] * OPL_CHANNELS   # (midi_chan, note)
+    programs = {}                      # gm_bank program -> MIDI channel
+    chan_program = [None] * 16
+    events = []
+    unmatched = set()
+
+    def note_off(tick, ch):
+        mc, note = sounding[ch]
+        events.append((tick, len(events), 0x80 | mc, note, 0))
+        sounding[ch] = None
+
+    for tick, reg, val in writes:
+        was_on = 0xB0 <= reg < 0xB0 + OPL_CHANNELS and regs[reg] & 0x20
+        regs[reg] = val
+        if not 0xB0 <= reg < 0xB0 + OPL_CHANNELS:
+            continue
+        ch = reg - 0xB0
+        if was_on and sounding[ch]:
+            note_off(tick, ch)   # Key off, or a retrigger
+        if not val & 0x20:
+            continue
+
+        patch = channel_patch(regs, ch)
+        prog, exact = match_patch(patch, bank, drums)
+        if not exact:
+            unmatched.add((ch, patch, prog))
+        if prog in DRUM_NOTES:
+            mc, note = DRUM_MIDI_CHANNEL, DRUM_NOTES[prog]
+            vel = velocity(drums[prog][6], regs[0x40 + CAR_OFFSETS[ch]])
+        else:
+            if prog not in programs:
+                free = [c for c in range(16) if c != DRUM_MIDI_CHANNEL and c not in programs.values()]
+                if not free:
+                    raise ValueError("More than 15 instruments")
+                programs[prog] = free[0]
+            mc = programs[prog]
+            if chan_program[mc] != prog:
+                events.append((tick, len(events), 0xC0 | mc, prog, None))
+                chan_program[mc] = prog
+            note = opl_note(val, regs[0xA0 + ch])
+            vel = velocity(bank[prog][6], regs[0x40 + CAR_OFFSETS[ch]])
+        events.append((tick, len(events), 0x90 | mc, note, vel))
+        sounding[ch] = (mc, note)
+
+    return events, unmatched
+
+
+def varlen(value):
+    out = [value & 0x7F]
+    value >>= 7
+    while value:
+        out.append(0x80 | (value & 0x7F))
+        value >>= 7
+    return bytes(reversed(out))
+
+
+def write_midi(path, events, end_tick):
+    track = bytearray(b'\x00\xFF\x51\x03' + TEMPO.to_bytes(3, 'big'))
+    prev = 0
+    for tick, _, status, a, b in events:
+        t = tick * TICK_MIDI
+        track += varlen(t - prev) + bytes([status, a] + ([] if b is None else [b]))
+        prev = t
+    track += varlen(max(0, end_tick * TICK_MIDI - prev)) + b'\xFF\x2F\x00'
+
+    with open(path, 'wb') as f:
+        f.write(b'MThd' + struct.pack('>IHHH', 6, 0, 1, PPQ))
+        f.write(b'MTrk' + struct.pack('>I', len(track)) + track)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert an OPL2 register stream to MIDI")
+    parser.add_argument("input")
+    parser.add_argument("output")
+    parser.add_argument("--instruments", default=DEFAULT_INSTRUMENTS)
+    args = parser.parse_args()
+
+    bank, drums = load_instruments(args.instruments)
+    writes, end_tick = read_stream(args.input)
+    events, unmatched = convert(writes, bank, drums)
+    write_midi(args.output, events, end_tick)
+
+    notes = sum(1 for e in events if e[2] & 0xF0 == 0x90)
+    print(f"{args.output}: {notes} notes, {end_tick / 60:.1f} s")
+    for ch, patch, prog in sorted(unmatched):
+        print(f"  channel {ch}: patch {patch} is not in the bank, using program {prog}",
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -3,14 +3,64 @@
 Process track tiles to generate collision masks, properties, and map binaries.
 Based on generate_collision_masks.py logic but outputs binary files.
 
-Usage: ./process_track.py <tiles.bin> <output_dir>
+Usage: ./process_track.py <tiles.bin> <output_dir> [triggers.json]
+                          [--map16 map16.bin --width W]
+
+Property byte (must match track.h):
+- bits 0-1: surface (0=Road, 1=Grass, 2=Wall)
+- bits 2-4: trigger (0=None, 1=Boost pad, 2=Oil slick, 3=Pickup)
+
+triggers.json names the tiles that carry a trigger, e.g.
+    {"boost": [200, 201], "oil": [57], "pickup": [90]}
+Triggers ride on the probe the game already makes at the car centre, so
+tagging a tile costs nothing at runtime. Wall tiles can't carry one.
+
+Tilesets beyond 256 tiles: Mode 2 maps hold one byte per tile, so tiles.bin
+is up to MAX_BANKS banks of 256 tiles back to back and each 8x8-tile
+chunk of the map draws from one bank. --map16 takes the map with 16-bit
+little-endian tile ids (export_map.lua can write it) and splits it into
+map.bin (low bytes) and banks.bin (one bank byte per chunk, row-major).
+The plane shows the bank of the chunk at the screen centre, so any chunk
+that can share the screen with a chunk of another bank may only use tiles
+that look the same in every bank; the split checks this.
 """
 
 import sys
 import os
+import argparse
+import json
 import struct
 
-def process_track(bin_file, output_dir):
+TILES_PER_BANK = 256
+MAX_BANKS = 2         # TRACK_MAX_BANKS comes from the largest tiles.bin (tools/track_layouts.cmake)
+CHUNK_TILES = 8       # MAP_CHUNK_TILES in track.h
+TILE_BYTES = 32
+# Chunks that can be on screen with the centre chunk (320x240 screen)
+REACH_X = 3
+REACH_Y = 2
+
+TRIGGER_SHIFT = 2
+TRIGGERS = {"boost": 1, "oil": 2, "pickup": 3}
+
+
+def load_triggers(path):
+    """Tile id -> trigger id from a triggers.json file."""
+    with open(path) as f:
+        spec = json.load(f)
+    tile_triggers = {}
+    for name, tiles in spec.items():
+        if name not in TRIGGERS:
+            print(f"Error: Unknown trigger '{name}' (expected one of {', '.join(TRIGGERS)})")
+            sys.exit(1)
+        for tile_id in tiles:
+            if tile_id in tile_triggers:
+                print(f"Error: Tile {tile_id} has more than one trigger")
+                sys.exit(1)
+            tile_triggers[tile_id] = TRIGGERS[name]
+    return tile_triggers
+
+
+def process_track(bin_file, output_dir, tile_triggers=None):
     # Color definitions
     ROAD_COLORS = {1, 2}           # Road (passable, no slowdown)
     TERRAIN_COLORS = {3, 8}        # Terrain/grass (passable, slowdown)
@@ -26,8 +76,11 @@ def process_track(bin_file, output_dir):
     num_tiles = len(tile_data) // 32
     print(f"Processing {num_tiles} tiles from {bin_file}...")
 
-    if num_tiles > 256:
-        print(f"WARNING: Tile count ({num_tiles}) exceeds 256! Tiles > 255 cannot be indexed in the map.")
+    if num_tiles > TILES_PER_BANK * MAX_BANKS:
+        print(f"Error: Tile count ({num_tiles}) exceeds {MAX_BANKS} banks of {TILES_PER_BANK}")
+        sys.exit(1)
+    if num_tiles > TILES_PER_BANK:
+        print(f"{num_tiles} tiles: banked tileset, split the map with --map16")
 
     collision_masks = bytearray()
     tile_properties = bytearray()
@@ -102,6 +155,13 @@ def process_track(bin_file, output_dir):
             else:
                 prop_val = TERRAIN_WALL
         
+        trigger = (tile_triggers or {}).get(tile_id, 0)
+        if trigger:
+            if prop_val == TERRAIN_WALL:
+                print(f"Error: Tile {tile_id} is a wall and can't carry a trigger")
+                sys.exit(1)
+            prop_val |= trigger << TRIGGER_SHIFT
+
         tile_properties.append(prop_val)
 
     # Write Outputs
@@ -116,14 +176,106 @@ def process_track(bin_file, output_dir):
     print(f"Wrote {len(tile_properties)} bytes to {prop_path}")
 
 
+def shared_tiles(tile_data):
+    """Map bytes whose tile is pixel-identical in every bank."""
+    banks = (len(tile_data) // TILE_BYTES + TILES_PER_BANK - 1) // TILES_PER_BANK
+    shared = set()
+    for index in range(TILES_PER_BANK):
+        pixels = [tile_data[(b * TILES_PER_BANK + index) * TILE_BYTES:
+                            (b * TILES_PER_BANK + index + 1) * TILE_BYTES] for b in range(banks)]
+        if all(len(p) == TILE_BYTES and p == pixels[0] for p in pixels):
+            shared.add(index)
+    return shared
+
+
+def split_map16(map16_file, width, tile_data, output_dir):
+    """Split a 16-bit map into map.bin and per-chunk banks.bin."""
+    with open(map16_file, 'rb') as f:
+        raw = f.read()
+    ids = list(struct.unpack(f"<{len(raw) // 2}H", raw[:len(raw) // 2 * 2]))
+    height = len(ids) // width
+    if width % CHUNK_TILES or height % CHUNK_TILES or width * height != len(ids):
+        print(f"Error: {map16_file} is not a {width}-wide map with sides in multiples of {CHUNK_TILES}")
+        sys.exit(1)
+
+    num_tiles = len(tile_data) // TILE_BYTES
+    for tile_id in ids:
+        if tile_id >= num_tiles:
+            print(f"Error: Tile id {tile_id} is past the end of the tileset ({num_tiles} tiles)")
+            sys.exit(1)
+
+    shared = shared_tiles(tile_data)
+    chunks_w = width // CHUNK_TILES
+    chunks_h = height // CHUNK_TILES
+
+    # Bank each chunk needs, None if it only uses shared tiles
+    need = {}
+    for cy in range(chunks_h):
+        for cx in range(chunks_w):
+            banks = set()
+            for ty in range(cy * CHUNK_TILES, (cy + 1) * CHUNK_TILES):
+                for tx in range(cx * CHUNK_TILES, (cx + 1) * CHUNK_TILES):
+                    tile_id = ids[ty * width + tx]
+                    if tile_id % TILES_PER_BANK not in shared:
+                        banks.add(tile_id // TILES_PER_BANK)
+            if len(banks) > 1:
+                print(f"Error: Chunk ({cx},{cy}) mixes tiles from banks {sorted(banks)}")
+                sys.exit(1)
+            need[(cx, cy)] = banks.pop() if banks else None
+
+    # Shared-only chunks follow the nearest chunk with a bank, so the plane
+    # switches banks as rarely as possible
+    fixed = [(c, b) for c, b in need.items() if b is not None]
+    bank_of = {}
+    for c, b in need.items():
+        if b is None:
+            near = min(fixed, key=lambda f: abs(f[0][0] - c[0]) + abs(f[0][1] - c[1]), default=(c, 0))
+            b = near[1]
+        bank_of[c] = b
+
+    # With the screen centred anywhere in a chunk, its neighbours must draw
+    # right in its bank
+    errors = 0
+    for (cx, cy), b in bank_of.items():
+        for dy in range(-REACH_Y, REACH_Y + 1):
+            for dx in range(-REACH_X, REACH_X + 1):
+                other = (cx + dx, cy + dy)
+                if other not in need or need[other] is None or need[other] == b:
+                    continue
+                print(f"Error: Chunk ({other[0]},{other[1]}) (bank {need[other]}) can be on screen "
+                      f"while chunk ({cx},{cy}) picks bank {b}")
+                errors += 1
+    if errors:
+        sys.exit(1)
+
+    map_path = os.path.join(output_dir, "map.bin")
+    with open(map_path, 'wb') as f:
+        f.write(bytes(tile_id & 0xFF for tile_id in ids))
+    print(f"Wrote {len(ids)} bytes to {map_path}")
+
+    banks_path = os.path.join(output_dir, "banks.bin")
+    with open(banks_path, 'wb') as f:
+        f.write(bytes(bank_of[(cx, cy)] for cy in range(chunks_h) for cx in range(chunks_w)))
+    print(f"Wrote {chunks_w * chunks_h} bytes to {banks_path}")
+
+
 if __name__ == "__main__":
-    if len(sys.argv) != 3:
-        print(f"Usage: {sys.argv[0]} <path_to_Track_A_tiles.bin> <output_dir>")
+    parser = argparse.ArgumentParser(description="Build collision masks, properties and map binaries for a track")
+    parser.add_argument("tiles", help="Track tiles.bin")
+    parser.add_argument("output_dir")
+    parser.add_argument("triggers", nargs="?", help="triggers.json")
+    parser.add_argument("--map16", help="Map with 16-bit tile ids to split into map.bin and banks.bin")
+    parser.add_argument("--width", type=int, help="Map width in tiles (with --map16)")
+    args = parser.parse_args()
+
+    bin_file = args.tiles
+    out_dir = args.output_dir
+    tile_triggers = load_triggers(args.triggers) if args.triggers else None
+
+    if args.map16 and not args.width:
+        print("Error: --map16 needs --width")
         sys.exit(1)
     
-    bin_file = sys.argv[1]
-    out_dir = sys.argv[2]
-    
     if not os.path.exists(bin_file):
         print(f"Error: File not found: {bin_file}")
         sys.exit(1)
@@ -131,4 +283,8 @@ if __name__ == "__main__":
     if not os.path.exists(out_dir):
         os.makedirs(out_dir)
     
-    process_track(bin_file, out_dir)
+    process_track(bin_file, out_dir, tile_triggers)
+
+    if args.map16:
+        with open(bin_file, 'rb') as f:
+            split_map16(args.map16, args.width, f.read(), out_dir)
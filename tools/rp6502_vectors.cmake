@@ -0,0 +1,28 @@
+# Run rp6502.py create with NMI/IRQ vectors taken from function addresses
+# in the linked ELF. Called by rp6502_executable() (tools/CMakeLists.txt):
+#
+#   cmake -DNM=<llvm-nm> -DELF=<name.elf> -DVECTORS=-i|audio_irq
+#         -DTOOL=<python|rp6502.py|options> -DARGS=<-o|out|create|...> -P rp6502_vectors.cmake
+#
+# Lists arrive with | in place of ;.
+
+foreach(var NM ELF VECTORS TOOL ARGS)
+    string(REPLACE "|" ";" ${var} "${${var}}")
+endforeach()
+
+execute_process(COMMAND ${NM} ${ELF} OUTPUT_VARIABLE symbols COMMAND_ERROR_IS_FATAL ANY)
+
+set(vector_args)
+list(LENGTH VECTORS count)
+math(EXPR last "${count} - 1")
+foreach(i RANGE 0 ${last} 2)
+    math(EXPR j "${i} + 1")
+    list(GET VECTORS ${i} flag)
+    list(GET VECTORS ${j} symbol)
+    if (NOT symbols MATCHES "(^|\n)([0-9A-Fa-f]+) [Tt] ${symbol}(\n|$)")
+        message(FATAL_ERROR "Vector ${symbol} not found in ${ELF}")
+    endif ()
+    list(APPEND vector_args ${flag} 0x${CMAKE_MATCH_2})
+endforeach()
+
+execute_process(COMMAND ${TOOL} ${vector_args} ${ARGS} COMMAND_ERROR_IS_FATAL ANY)
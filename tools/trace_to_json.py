@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+Convert a trace dump (trace.bin, see src/trace.h) to Chrome trace JSON.
+
+Build with -DENABLE_TRACE=ON, press F9 after a stutter and load the JSON in
+chrome://tracing (about:tracing) or https://ui.perfetto.dev. Stage names
+come from the TRACE_STAGES list in src/trace.h, in id order.
+
+File format (little endian):
+- header: "RTRC", uint8 version, uint8 event size
+- events, oldest first: uint8 id (bit 7 end, bit 6 instant), uint8 vsync,
+  uint16 frame timer (256-cycle units since that vsync)
+
+Timestamps: the 8-bit vsync counter is unwrapped in file order (the ring
+holds many events per frame, so it never skips a whole wrap), then
+ts = frame * 1/60 s + timer * 256 cycles at 8 MHz.
+
+Usage: ./trace_to_json.py <trace.bin> [-o trace.json] [--header src/trace.h]
+"""
+
+import sys
+import os
+import re
+import json
+import argparse
+import struct
+
+TRACE_VERSION = 1  # Must match trace.h
+HEADER = b"RTRC"
+EVENT = struct.Struct("<BBH")
+END_BIT = 0x80
+MARK_BIT = 0x40
+
+PHI2_HZ = 8000000
+FRAME_US = 1e6 / 60
+UNIT_US = 256 * 1e6 / PHI2_HZ
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+
+
+def load_stage_names(header_path):
+    """Stage names from the X(id, "name") lines of TRACE_STAGES, in id order."""
+    with open(header_path) as f:
+        text = f.read()
+    block = text[text.index("#define TRACE_STAGES(X)"):]
+    block = block[:block.index("\n\n")]
+    return [name for _, name in re.findall(r'X\((\w+),\s*"([^"]*)"\)', block)]
+
+
+def convert(trace_path, names):
+    with open(trace_path, 'rb') as f:
+        data = f.read()
+
+    if data[:4] != HEADER:
+        print(f"Error: {trace_path} is not a trace dump")
+        sys.exit(1)
+    if data[4] != TRACE_VERSION or data[5] != EVENT.size:
+        print(f"Error: Trace version {data[4]} / event size {data[5]}, "
+              f"expected {TRACE_VERSION} / {EVENT.size}")
+        sys.exit(1)
+
+    events = []
+    open_stages = []  # Stack of begun stages, so ends match begins
+    frame = 0
+    last_vsync = None
+    body = data[6:]
+    for offset in range(0, len(body) - EVENT.size + 1, EVENT.size):
+        tag, vsync, timer = EVENT.unpack_from(body, offset)
+        if last_vsync is not None:
+            frame += (vsync - last_vsync) & 0xFF
+        last_vsync = vsync
+
+        stage = tag & 0x3F
+        name = names[stage] if stage < len(names) else f"stage {stage}"
+        ts = frame * FRAME_US + timer * UNIT_US
+        event = {"name": name, "ts": round(ts, 1), "pid": 1, "tid": 1}
+
+        if tag & MARK_BIT:
+            event.update(ph="i", s="g")
+        elif tag & END_BIT:
+            if stage not in open_stages:
+                continue  # Began before the oldest event in the ring
+            # Close anything left open inside it first
+            while open_stages[-1] != stage:
+                events.append({**event, "name": names[open_stages.pop()], "ph": "E"})
+            open_stages.pop()
+            event["ph"] = "E"
+        else:
+            open_stages.append(stage)
+            event["ph"] = "B"
+        event["args"] = {"frame": frame}
+        events.append(event)
+
+    # Stages still running when the ring froze
+    for stage in reversed(open_stages):
+        events.append({"name": names[stage], "ph": "E", "ts": events[-1]["ts"], "pid": 1, "tid": 1})
+
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert a trace dump to Chrome trace JSON")
+    parser.add_argument("trace", help="trace.bin from the USB drive")
+    parser.add_argument("-o", "--output", help="JSON file (default: next to the dump)")
+    parser.add_argument("--header", default=os.path.join(ROOT, "src", "trace.h"))
+    args = parser.parse_args()
+
+    if not os.path.exists(args.trace):
+        print(f"Error: File not found: {args.trace}")
+        sys.exit(1)
+
+    trace = convert(args.trace, load_stage_names(args.header))
+    out_path = args.output or os.path.splitext(args.trace)[0] + ".json"
+    with open(out_path, 'w') as f:
+        json.dump(trace, f)
+    print(f"Wrote {len(trace['traceEvents'])} events to {out_path}")
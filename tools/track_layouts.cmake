@@ -0,0 +1,60 @@
+# Track layout header for src/track.c.
+#
+#  write_track_layouts(<header> <track_dir>[:<width>] ...)
+#
+# One entry per track directory, in track id order (the first is track 1).
+# A map is 64 tiles wide (one XRAM window) unless the entry gives its width,
+# e.g. build/track04:72. Its height is what map.bin holds at that width, and
+# its bank count is tiles.bin in whole 8 KB banks (TRACK_DATA_SIZE). The
+# header defines TRACK_LAYOUT_COUNT, TRACK_LAYOUTS (the table rows) and
+# TRACK_MAX_BANKS (the most banks any track has; the tile tables are sized
+# for it). It is only rewritten when a layout changes, and CMake re-runs
+# when any map.bin or tiles.bin does.
+#
+function(write_track_layouts header)
+    set(count 0)
+    set(max_banks 1)
+    set(rows "")
+    foreach(entry IN LISTS ARGN)
+        if (entry MATCHES "^(.+):([0-9]+)$")
+            set(dir ${CMAKE_MATCH_1})
+            set(width ${CMAKE_MATCH_2})
+        else ()
+            set(dir ${entry})
+            set(width 64)
+        endif ()
+        get_filename_component(dir ${dir} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_SOURCE_DIR})
+        get_filename_component(name ${dir} NAME)
+
+        file(SIZE ${dir}/map.bin map_size)
+        math(EXPR height "${map_size} / ${width}")
+        math(EXPR check "${height} * ${width}")
+        if (NOT check EQUAL map_size OR width GREATER 128 OR height GREATER 128)
+            message(FATAL_ERROR "${dir}/map.bin (${map_size} bytes) is not a map ${width} tiles wide, up to 128x128")
+        endif ()
+        file(SIZE ${dir}/tiles.bin tiles_size)
+        math(EXPR banks "(${tiles_size} + 8191) / 8192")
+        if (banks GREATER max_banks)
+            set(max_banks ${banks})
+        endif ()
+
+        string(APPEND rows "    {${width}, ${height}, ${banks}}, /* ${name} */ \\\n")
+        math(EXPR count "${count} + 1")
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${dir}/map.bin ${dir}/tiles.bin)
+    endforeach()
+
+    file(CONFIGURE OUTPUT ${header} CONTENT
+"// Generated by write_track_layouts() (tools/track_layouts.cmake) from the
+// track directories. Don't edit; rebuild instead.
+#ifndef TRACK_LAYOUTS_H
+#define TRACK_LAYOUTS_H
+
+#define TRACK_LAYOUT_COUNT ${count}
+#define TRACK_MAX_BANKS    ${max_banks}
+
+// {w_tiles, h_tiles, banks} per track (index = track id - 1)
+#define TRACK_LAYOUTS \\
+${rows}
+#endif // TRACK_LAYOUTS_H
+" @ONLY)
+endfunction()